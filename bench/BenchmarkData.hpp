@@ -0,0 +1,127 @@
+#pragma once
+
+#include "repositories/vector/VectorRepository.hpp"
+#include "util/embedding/EmbeddingMatrix.hpp"
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    // Fixed seed so every run serializes and parses identical inputs
+    inline std::vector<float> RandomVector(size_t dimension, unsigned int seed = 42)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        std::vector<float> values(dimension);
+        for (auto &value : values)
+        {
+            value = distribution(generator);
+        }
+        return values;
+    }
+
+    inline util::embedding::EmbeddingMatrix RandomMatrix(size_t rows, size_t dimension)
+    {
+        util::embedding::EmbeddingMatrix matrix(dimension);
+        matrix.Reserve(rows);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            matrix.AppendRow(RandomVector(dimension, static_cast<unsigned int>(i)));
+        }
+        return matrix;
+    }
+
+    inline std::string SampleText(size_t words)
+    {
+        static const char *const vocabulary[] = {"retrieval", "augmented", "generation", "vector", "database",
+                                                 "corporate", "knowledge", "article", "embedding", "query"};
+        std::string text;
+        for (size_t i = 0; i < words; ++i)
+        {
+            if (i > 0)
+                text += ' ';
+            text += vocabulary[i % 10];
+        }
+        return text;
+    }
+
+    // Points view rows of `vectors`, which moves with the batch
+    struct PointBatch
+    {
+        util::embedding::EmbeddingMatrix vectors;
+        std::vector<repositories::vector::VectorPoint> points;
+    };
+
+    inline PointBatch RandomPoints(size_t count, size_t dimension)
+    {
+        PointBatch batch{RandomMatrix(count, dimension), {}};
+        batch.points.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            batch.points.push_back(repositories::vector::VectorPoint{
+                static_cast<repositories::vector::PointId>(i),
+                batch.vectors.Row(i),
+                "{\"text\":\"" + SampleText(16) + "\"}"});
+        }
+        return batch;
+    }
+
+    // Body shaped like llama.cpp's /v1/embeddings reply
+    inline std::string EmbeddingResponse(size_t dimension)
+    {
+        const std::vector<float> embedding = RandomVector(dimension);
+        std::ostringstream body;
+        body << "{\"object\":\"list\",\"data\":[{\"object\":\"embedding\",\"index\":0,\"embedding\":[";
+        for (size_t i = 0; i < embedding.size(); ++i)
+        {
+            if (i > 0)
+                body << ",";
+            body << embedding[i];
+        }
+        body << "]}],\"model\":\"bench\",\"usage\":{\"prompt_tokens\":8,\"total_tokens\":8}}";
+        return body.str();
+    }
+
+    // Body shaped like Qdrant's /points/search reply
+    inline std::string SearchResponse(size_t results, size_t payload_words)
+    {
+        std::ostringstream body;
+        body << "{\"result\":[";
+        for (size_t i = 0; i < results; ++i)
+        {
+            if (i > 0)
+                body << ",";
+            body << "{\"id\":" << i << ",\"version\":0,\"score\":" << 1.0 - 0.01 * static_cast<double>(i)
+                 << ",\"payload\":{\"text\":\"" << SampleText(payload_words) << "\"}}";
+        }
+        body << "],\"status\":\"ok\",\"time\":0.0001}";
+        return body.str();
+    }
+
+    // Body shaped like Qdrant's /points/scroll reply, with vectors and payloads
+    inline std::string ScrollResponse(size_t points, size_t dimension)
+    {
+        std::ostringstream body;
+        body.precision(9);
+        body << "{\"result\":{\"points\":[";
+        for (size_t i = 0; i < points; ++i)
+        {
+            if (i > 0)
+                body << ",";
+            body << "{\"id\":" << i << ",\"payload\":{\"key\":\"doc-" << i << "\",\"text\":\"" << SampleText(16) << "\"},\"vector\":[";
+            const std::vector<float> vector = RandomVector(dimension, static_cast<unsigned int>(i));
+            for (size_t j = 0; j < vector.size(); ++j)
+            {
+                if (j > 0)
+                    body << ",";
+                body << vector[j];
+            }
+            body << "]}";
+        }
+        body << "],\"next_page_offset\":" << points << "},\"status\":\"ok\",\"time\":0.0001}";
+        return body.str();
+    }
+};
@@ -0,0 +1,37 @@
+#include "BenchmarkData.hpp"
+
+#include "util/embedding/EmbeddingMatrix.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    // Args: {embedding dimension, rows}; brute-force cosine scoring of normalized rows
+    void BM_ScoreRows(benchmark::State &state)
+    {
+        util::embedding::EmbeddingMatrix matrix = bench::RandomMatrix(state.range(1), state.range(0));
+        matrix.NormalizeRows();
+        const std::vector<float> query = bench::RandomVector(state.range(0), 7);
+        for (auto _ : state)
+        {
+            std::vector<float> scores = util::embedding::ScoreRows(matrix, query);
+            benchmark::DoNotOptimize(scores);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(1));
+    }
+    BENCHMARK(BM_ScoreRows)->ArgsProduct({{384, 768, 1000, 1024}, {1024, 16384}});
+
+    // Args: {embedding dimension, rows}
+    void BM_NormalizeRows(benchmark::State &state)
+    {
+        const util::embedding::EmbeddingMatrix source = bench::RandomMatrix(state.range(1), state.range(0));
+        util::embedding::EmbeddingMatrix matrix = source;
+        for (auto _ : state)
+        {
+            matrix.NormalizeRows();
+            benchmark::DoNotOptimize(matrix.Data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(1));
+    }
+    BENCHMARK(BM_NormalizeRows)->ArgsProduct({{384, 768, 1024}, {64}});
+}
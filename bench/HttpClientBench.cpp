@@ -0,0 +1,49 @@
+#include "BenchmarkData.hpp"
+
+#include "util/http_client/HttpClient.hpp"
+
+#include "common/HttpServer.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    // Args: {request body bytes, response body bytes}
+    void BM_HttpClientRoundTrip(benchmark::State &state)
+    {
+        const std::string reply_body(state.range(1), 'x');
+        tools::common::HttpServer server([&reply_body](const tools::common::HttpRequest &)
+                                         { return tools::common::HttpReply{200, reply_body}; });
+        const util::http::HttpClient client(server.BaseUrl());
+        const std::string request_body(state.range(0), 'y');
+
+        for (auto _ : state)
+        {
+            util::http::HttpResponse response = client.Post("/echo", request_body);
+            if (response.status_code != 200)
+            {
+                state.SkipWithError("loopback request failed");
+                break;
+            }
+            benchmark::DoNotOptimize(response);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * (state.range(0) + state.range(1))));
+    }
+    BENCHMARK(BM_HttpClientRoundTrip)->ArgsProduct({{64, 16 << 10, 256 << 10}, {64, 16 << 10}})->UseRealTime();
+
+    // Args: {embedding dimension}; an upsert of one point with a realistic body
+    void BM_HttpClientUpsertBody(benchmark::State &state)
+    {
+        tools::common::HttpServer server([](const tools::common::HttpRequest &)
+                                         { return tools::common::HttpReply{200, "{\"result\":{\"status\":\"acknowledged\"},\"status\":\"ok\"}"}; });
+        const util::http::HttpClient client(server.BaseUrl());
+        const std::string body = repositories::vector::VectorRepository::SerializePoints(bench::RandomPoints(1, state.range(0)).points);
+
+        for (auto _ : state)
+        {
+            util::http::HttpResponse response = client.Put("/collections/bench/points", body);
+            benchmark::DoNotOptimize(response);
+        }
+    }
+    BENCHMARK(BM_HttpClientUpsertBody)->Arg(384)->Arg(768)->Arg(1024)->UseRealTime();
+}
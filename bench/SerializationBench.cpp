@@ -0,0 +1,129 @@
+#include "BenchmarkData.hpp"
+
+#include "repositories/vector/VectorRepository.hpp"
+#include "services/embedder/EmbedderService.hpp"
+#include "services/llm/LlmService.hpp"
+#include "util/env/EnvLoader.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    using repositories::vector::VectorRepository;
+
+    // Args: {embedding dimension, points per upsert}
+    void BM_SerializePoints(benchmark::State &state)
+    {
+        const bench::PointBatch batch = bench::RandomPoints(state.range(1), state.range(0));
+        size_t bytes = 0;
+        for (auto _ : state)
+        {
+            std::string body = VectorRepository::SerializePoints(batch.points);
+            bytes += body.size();
+            benchmark::DoNotOptimize(body);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(bytes));
+        state.SetItemsProcessed(state.iterations() * state.range(1));
+    }
+    BENCHMARK(BM_SerializePoints)->ArgsProduct({{384, 768, 1024}, {1, 16, 64}});
+
+    // Args: {embedding dimension}
+    void BM_SerializeSearchRequest(benchmark::State &state)
+    {
+        const std::vector<float> query = bench::RandomVector(state.range(0));
+        for (auto _ : state)
+        {
+            std::string body = VectorRepository::SerializeSearchRequest(query, 5);
+            benchmark::DoNotOptimize(body);
+        }
+    }
+    BENCHMARK(BM_SerializeSearchRequest)->Arg(384)->Arg(768)->Arg(1024);
+
+    // Args: {embedding dimension}
+    void BM_ParseEmbeddingResponse(benchmark::State &state)
+    {
+        const std::string body = bench::EmbeddingResponse(state.range(0));
+        for (auto _ : state)
+        {
+            util::embedding::EmbeddingMatrix embedding = services::embedder::EmbedderService::ParseEmbeddingResponse(body);
+            benchmark::DoNotOptimize(embedding);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+    }
+    BENCHMARK(BM_ParseEmbeddingResponse)->Arg(384)->Arg(768)->Arg(1024);
+
+    // Args: {results per search, words per payload}
+    void BM_ParseSearchResponse(benchmark::State &state)
+    {
+        const std::string body = bench::SearchResponse(state.range(0), state.range(1));
+        util::arena::RequestArena arena;
+        for (auto _ : state)
+        {
+            auto results = VectorRepository::ParseSearchResponse(body, arena);
+            benchmark::DoNotOptimize(results);
+            arena.Release();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+    }
+    BENCHMARK(BM_ParseSearchResponse)->ArgsProduct({{5, 20, 100}, {16, 256}});
+
+    // Args: {points per page, embedding dimension}
+    void BM_ParseScrollResponse(benchmark::State &state)
+    {
+        const std::string body = bench::ScrollResponse(state.range(0), state.range(1));
+        for (auto _ : state)
+        {
+            repositories::vector::ScrollPage page = VectorRepository::ParseScrollResponse(body);
+            benchmark::DoNotOptimize(page);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(BM_ParseScrollResponse)->ArgsProduct({{64, 256}, {384, 1024}});
+
+    // Args: {context documents, words per document}; prompt fragments plus the completion request body
+    void BM_BuildPrompt(benchmark::State &state)
+    {
+        const std::string text = bench::SampleText(state.range(1));
+        const std::vector<std::string_view> documents(state.range(0), text);
+        const std::string question = "What is RAG and why is it useful in corporate?";
+        util::arena::RequestArena arena;
+        for (auto _ : state)
+        {
+            {
+                auto fragments = services::llm::LlmService::BuildPrompt(question, documents, 128, arena);
+                std::string_view body = repositories::llm::LlmRepository::SerializeCompletionRequest(fragments, 128, arena);
+                benchmark::DoNotOptimize(body);
+            }
+            arena.Release();
+        }
+    }
+    BENCHMARK(BM_BuildPrompt)->ArgsProduct({{1, 5, 20}, {16, 256}});
+
+    // Args: {lines in the .env file}
+    void BM_EnvLoaderLoad(benchmark::State &state)
+    {
+        // Kept out of the working directory, which is often the repo root
+        const std::string path = (std::filesystem::temp_directory_path() / "rag_bench.env").string();
+        {
+            std::ofstream file(path);
+            file << "# generated by rag_bench\n";
+            for (int64_t i = 0; i < state.range(0); ++i)
+            {
+                file << "KEY_" << i << " = \"http://localhost:" << 8000 + i << "\"\n";
+            }
+        }
+
+        for (auto _ : state)
+        {
+            util::env::EnvLoader loader;
+            benchmark::DoNotOptimize(loader.Load(path));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        std::filesystem::remove(path);
+    }
+    BENCHMARK(BM_EnvLoaderLoad)->Arg(4)->Arg(64)->Arg(1024);
+}
@@ -0,0 +1,223 @@
+#include "BatchRunner.hpp"
+
+#include "util/concurrency/ThreadPool.hpp"
+#include "util/trace/Tracer.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+
+using json = nlohmann::json;
+
+namespace batch
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        double ElapsedMs(Clock::time_point start, Clock::time_point end)
+        {
+            return std::chrono::duration<double, std::milli>(end - start).count();
+        }
+    }
+
+    std::vector<BatchQuery> LoadQueries(const std::string &filepath)
+    {
+        std::ifstream file(filepath);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Could not open query file: " + filepath);
+        }
+
+        std::vector<BatchQuery> queries;
+        std::string line;
+        size_t line_number = 0;
+        while (std::getline(file, line))
+        {
+            ++line_number;
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+            {
+                continue;
+            }
+
+            json query_json = json::parse(line);
+            if (!query_json.contains("query") || !query_json["query"].is_string())
+            {
+                throw std::runtime_error("Missing \"query\" on line " + std::to_string(line_number) + " of " + filepath);
+            }
+
+            BatchQuery query;
+            query.query = query_json["query"].get<std::string>();
+            if (query_json.contains("id"))
+            {
+                query.id = query_json["id"].is_string() ? query_json["id"].get<std::string>() : query_json["id"].dump();
+            }
+            else
+            {
+                query.id = std::to_string(line_number);
+            }
+            queries.push_back(std::move(query));
+        }
+        return queries;
+    }
+
+    void WriteAnswers(const std::string &filepath, const std::vector<BatchAnswer> &answers)
+    {
+        std::ofstream file(filepath);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Could not open output file: " + filepath);
+        }
+
+        for (const auto &answer : answers)
+        {
+            json documents = json::array();
+            for (const auto &document : answer.documents)
+            {
+                documents.push_back({{"id", document.id}, {"score", document.score}});
+            }
+
+            json answer_json = {
+                {"id", answer.id},
+                {"query", answer.query},
+                {"answer", answer.answer},
+                {"documents", documents},
+                {"latency_ms",
+                 {{"embed", answer.latency.embed_ms},
+                  {"search", answer.latency.search_ms},
+                  {"generate", answer.latency.generate_ms},
+                  {"total", answer.latency.total_ms}}}};
+            if (!answer.error.empty())
+            {
+                answer_json["error"] = answer.error;
+            }
+            file << answer_json.dump() << '\n';
+        }
+    }
+
+    std::vector<BatchAnswer> BatchRunner::Run(const std::string &collection_name, const std::vector<BatchQuery> &queries) const
+    {
+        std::vector<BatchAnswer> answers(queries.size());
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            answers[i].id = queries[i].id;
+            answers[i].query = queries[i].query;
+        }
+
+        const size_t batch_size = std::max<size_t>(options.batch_size, 1);
+        util::concurrency::ThreadPool pool(options.thread_count);
+
+        for (size_t begin = 0; begin < queries.size(); begin += batch_size)
+        {
+            const size_t end = std::min(begin + batch_size, queries.size());
+            pool.Submit([this, &pool, &answers, &queries, &collection_name, begin, end]()
+                        {
+                util::trace::ScopedSpan span("batch.retrieve");
+                const Clock::time_point batch_start = Clock::now();
+                const util::context::RequestContext context = options.deadline.count() > 0
+                                                                  ? util::context::RequestContext::WithTimeout(options.deadline, batch_start)
+                                                                  : util::context::RequestContext::Background();
+
+                // Holds only the group's search results; answer tasks read their payloads from it
+                // and it is freed when the last one finishes
+                auto arena = std::make_shared<util::arena::RequestArena>();
+
+                std::vector<std::string> texts;
+                texts.reserve(end - begin);
+                for (size_t i = begin; i < end; ++i)
+                {
+                    texts.push_back(queries[i].query);
+                }
+
+                std::vector<std::vector<repositories::vector::SearchResult>> search_results;
+                double embed_ms = 0.0;
+                double search_ms = 0.0;
+                try
+                {
+                    Clock::time_point search_start = batch_start;
+                    if (options.retrieval != RetrievalMode::Lexical)
+                    {
+                        const util::embedding::EmbeddingMatrix embeddings = embedder_service.GetEmbeddings(texts, context);
+                        search_start = Clock::now();
+                        embed_ms = ElapsedMs(batch_start, search_start);
+                        search_results = vector_service.SearchSimilarBatch(collection_name, embeddings, *arena, options.top_k, context);
+                    }
+                    else
+                    {
+                        search_results.resize(texts.size());
+                    }
+
+                    if (options.retrieval != RetrievalMode::Dense)
+                    {
+                        for (size_t q = 0; q < texts.size(); ++q)
+                        {
+                            std::vector<repositories::vector::SearchResult> lexical = vector_service.SearchLexical(collection_name, texts[q], *arena, options.top_k);
+                            search_results[q] = options.retrieval == RetrievalMode::Lexical
+                                                    ? std::move(lexical)
+                                                    : services::vector::VectorService::FuseRankings({search_results[q], lexical}, options.top_k);
+                        }
+                    }
+                    search_ms = ElapsedMs(search_start, Clock::now());
+                }
+                catch (const std::exception &e)
+                {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        answers[i].error = e.what();
+                        answers[i].latency.total_ms = ElapsedMs(batch_start, Clock::now());
+                    }
+                    return;
+                }
+
+                for (size_t i = begin; i < end; ++i)
+                {
+                    BatchAnswer &answer = answers[i];
+                    answer.latency.embed_ms = embed_ms;
+                    answer.latency.search_ms = search_ms;
+                    answer.documents = std::move(search_results[i - begin]);
+
+                    // Generation dominates and is independent per query, so it fans out
+                    // onto this worker's deque where idle workers can steal it.
+                    pool.Submit([this, &answer, arena, batch_start, context]()
+                                {
+                        util::trace::ScopedSpan span("batch.answer", answer.id);
+                        if (answer.documents.empty())
+                        {
+                            answer.latency.total_ms = ElapsedMs(batch_start, Clock::now());
+                            return;
+                        }
+
+                        std::vector<std::string_view> context_documents;
+                        context_documents.reserve(answer.documents.size());
+                        for (auto &document : answer.documents)
+                        {
+                            context_documents.push_back(document.payload);
+                            // Only ids and scores are reported; drop the view before the arena goes away
+                            document.payload = {};
+                        }
+
+                        // Each answer builds its prompt in its own arena, so concurrent answers of a
+                        // group neither contend on one allocator nor hold each other's memory
+                        util::arena::RequestArena prompt_arena;
+                        const Clock::time_point generate_start = Clock::now();
+                        try
+                        {
+                            answer.answer = llm_service.GenerateAnswer(answer.query, context_documents, prompt_arena, options.max_tokens, context);
+                        }
+                        catch (const std::exception &e)
+                        {
+                            answer.error = e.what();
+                        }
+                        const Clock::time_point generate_end = Clock::now();
+                        answer.latency.generate_ms = ElapsedMs(generate_start, generate_end);
+                        answer.latency.total_ms = ElapsedMs(batch_start, generate_end); });
+                } });
+        }
+
+        pool.WaitIdle();
+        return answers;
+    }
+};
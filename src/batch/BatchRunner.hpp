@@ -0,0 +1,84 @@
+#pragma once
+
+#include "services/embedder/EmbedderService.hpp"
+#include "services/vector/VectorService.hpp"
+#include "services/llm/LlmService.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace batch
+{
+    struct BatchQuery
+    {
+        std::string id;
+        std::string query;
+    };
+
+    struct StageLatencies
+    {
+        double embed_ms = 0.0;
+        double search_ms = 0.0;
+        double generate_ms = 0.0;
+        double total_ms = 0.0;
+    };
+
+    struct BatchAnswer
+    {
+        std::string id;
+        std::string query;
+        std::vector<repositories::vector::SearchResult> documents; // ids and scores; payloads are cleared once answered
+        std::string answer;
+        std::string error;
+        StageLatencies latency;
+    };
+
+    enum class RetrievalMode
+    {
+        Dense,
+        Lexical, // BM25 only, skips the embedder
+        Hybrid,  // dense and BM25 merged with reciprocal rank fusion
+    };
+
+    struct BatchOptions
+    {
+        size_t thread_count = std::thread::hardware_concurrency();
+        size_t batch_size = 16; // queries per embedding/search request
+        int top_k = 5;
+        unsigned int max_tokens = 128;
+        RetrievalMode retrieval = RetrievalMode::Hybrid;
+        // Budget for each query, counted from when its group starts retrieval; 0 for none
+        std::chrono::milliseconds deadline{0};
+    };
+
+    // Reads one {"id": ..., "query": ...} object per line; "id" defaults to the line number.
+    std::vector<BatchQuery> LoadQueries(const std::string &filepath);
+
+    // Writes one JSON object per answer, in input order.
+    void WriteAnswers(const std::string &filepath, const std::vector<BatchAnswer> &answers);
+
+    class BatchRunner
+    {
+    private:
+        const services::embedder::EmbedderService &embedder_service;
+        const services::vector::VectorService &vector_service;
+        const services::llm::LlmService &llm_service;
+        BatchOptions options;
+
+    public:
+        BatchRunner(const services::embedder::EmbedderService &embedder_service,
+                    const services::vector::VectorService &vector_service,
+                    const services::llm::LlmService &llm_service,
+                    BatchOptions options = {})
+            : embedder_service(embedder_service),
+              vector_service(vector_service),
+              llm_service(llm_service),
+              options(options) {}
+
+        // Embeds and searches queries in groups of options.batch_size, then generates
+        // every answer as its own task. Failures are reported per query, never thrown.
+        std::vector<BatchAnswer> Run(const std::string &collection_name, const std::vector<BatchQuery> &queries) const;
+    };
+};
@@ -0,0 +1,244 @@
+#include "CollectionExport.hpp"
+
+#include "util/trace/Tracer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+namespace indexing
+{
+    namespace
+    {
+        constexpr char kExportMagic[4] = {'R', 'A', 'G', 'X'};
+        // Offset of the dimension and point count, which are only known at the end
+        constexpr std::streamoff kDimensionOffset = sizeof(kExportMagic) + 2 * sizeof(uint32_t);
+
+        template <typename T>
+        void WriteValue(std::ofstream &file, const T &value)
+        {
+            file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        template <typename T>
+        bool ReadValue(std::ifstream &file, T &value)
+        {
+            return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(value)));
+        }
+    }
+
+    ExportReport ExportCollection(const services::vector::VectorService &vector_service,
+                                  const std::string &collection_name,
+                                  const std::string &filepath,
+                                  const ScrollOptions &options,
+                                  const util::context::RequestContext &context)
+    {
+        util::trace::ScopedSpan span("export.collection", collection_name);
+        ExportReport report;
+
+        const std::string temporary_path = filepath + ".tmp";
+        try
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                throw std::runtime_error("Could not write export: " + temporary_path);
+            }
+
+            const uint32_t flags = (options.with_vector ? kExportVectors : 0u) | (options.with_payload ? kExportPayloads : 0u);
+            file.write(kExportMagic, sizeof(kExportMagic));
+            WriteValue(file, kExportVersion);
+            WriteValue(file, flags);
+            WriteValue(file, report.dimension);
+            WriteValue(file, report.points);
+
+            CollectionScroller scroller(vector_service, collection_name, options, context);
+            for (const repositories::vector::ScrollPage *page = scroller.NextPage(); page != nullptr; page = scroller.NextPage())
+            {
+                if (options.with_vector)
+                {
+                    if (page->vectors.Rows() != page->Size())
+                    {
+                        throw std::runtime_error("Collection returned points without vectors: " + collection_name);
+                    }
+                    if (report.points == 0)
+                    {
+                        report.dimension = static_cast<uint32_t>(page->vectors.Dimension());
+                    }
+                    else if (page->vectors.Dimension() != report.dimension)
+                    {
+                        throw std::runtime_error("Collection has mixed vector sizes: " + collection_name);
+                    }
+                }
+
+                for (size_t i = 0; i < page->Size(); ++i)
+                {
+                    WriteValue(file, page->ids[i]);
+                    if (options.with_vector)
+                    {
+                        // Rows are padded to the matrix stride; only the values are written
+                        file.write(reinterpret_cast<const char *>(page->vectors.Row(i).data()),
+                                   static_cast<std::streamsize>(report.dimension * sizeof(float)));
+                    }
+                    if (options.with_payload)
+                    {
+                        const std::string_view payload = page->payloads.empty() ? std::string_view() : std::string_view(page->payloads[i]);
+                        if (payload.size() > std::numeric_limits<uint32_t>::max())
+                        {
+                            throw std::runtime_error("Payload too large to export for point " + std::to_string(page->ids[i]));
+                        }
+                        WriteValue(file, static_cast<uint32_t>(payload.size()));
+                        file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+                    }
+                }
+                report.points += page->Size();
+            }
+
+            file.seekp(kDimensionOffset);
+            WriteValue(file, report.dimension);
+            WriteValue(file, report.points);
+            file.seekp(0, std::ios::end);
+            report.bytes = static_cast<uint64_t>(file.tellp());
+            if (!file.good())
+            {
+                throw std::runtime_error("Could not write export: " + temporary_path);
+            }
+        }
+        catch (...)
+        {
+            // A partial export is worse than none
+            std::remove(temporary_path.c_str());
+            throw;
+        }
+
+        if (std::rename(temporary_path.c_str(), filepath.c_str()) != 0)
+        {
+            throw std::runtime_error("Could not replace export: " + filepath);
+        }
+        return report;
+    }
+
+    ExportReader::ExportReader(const std::string &filepath) : file(filepath, std::ios::binary)
+    {
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Could not open export: " + filepath);
+        }
+
+        char magic[sizeof(kExportMagic)];
+        uint32_t version = 0;
+        if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, kExportMagic, sizeof(magic)) != 0 ||
+            !ReadValue(file, version) || version != kExportVersion ||
+            !ReadValue(file, flags) || !ReadValue(file, dimension) || !ReadValue(file, point_count))
+        {
+            throw std::runtime_error("Not a version " + std::to_string(kExportVersion) + " export: " + filepath);
+        }
+
+        const std::streampos header_end = file.tellg();
+        file.seekg(0, std::ios::end);
+        file_size = static_cast<uint64_t>(file.tellg());
+        file.seekg(header_end);
+        if (HasVectors())
+        {
+            RequireBytes(static_cast<uint64_t>(dimension) * sizeof(float));
+        }
+    }
+
+    void ExportReader::RequireBytes(uint64_t count)
+    {
+        const auto position = static_cast<uint64_t>(file.tellg());
+        if (!file || position > file_size || count > file_size - position)
+        {
+            throw std::runtime_error("Corrupt export: a length of " + std::to_string(count) + " bytes runs past the end of the file");
+        }
+    }
+
+    bool ExportReader::Next(ExportedPoint &point)
+    {
+        if (read == point_count)
+        {
+            return false;
+        }
+
+        bool complete = ReadValue(file, point.id);
+        if (HasVectors())
+        {
+            if (complete)
+            {
+                RequireBytes(static_cast<uint64_t>(dimension) * sizeof(float));
+            }
+            point.vector.resize(dimension);
+            complete = complete && file.read(reinterpret_cast<char *>(point.vector.data()),
+                                             static_cast<std::streamsize>(dimension * sizeof(float)));
+        }
+        if (HasPayloads())
+        {
+            uint32_t length = 0;
+            complete = complete && ReadValue(file, length);
+            if (complete)
+            {
+                RequireBytes(length);
+            }
+            point.payload.resize(complete ? length : 0);
+            complete = complete && file.read(point.payload.data(), length);
+        }
+        if (!complete)
+        {
+            throw std::runtime_error("Export ends after " + std::to_string(read) + " of " + std::to_string(point_count) + " points");
+        }
+        ++read;
+        return true;
+    }
+
+    uint64_t ImportCollection(services::vector::VectorService &vector_service,
+                              const std::string &collection_name,
+                              const std::string &filepath,
+                              size_t batch_size)
+    {
+        util::trace::ScopedSpan span("import.collection", collection_name);
+        ExportReader reader(filepath);
+        if (!reader.HasVectors() || !reader.HasPayloads())
+        {
+            throw std::runtime_error("Only exports with vectors and payloads can be imported: " + filepath);
+        }
+
+        if (vector_service.GetCollection(collection_name).status_code == 404)
+        {
+            vector_service.CreateCollection(collection_name, static_cast<int>(reader.Dimension())).ThrowErrorIfFailed();
+        }
+
+        // Vectors are staged in one matrix that is reused for every batch
+        batch_size = std::max<size_t>(batch_size, 1);
+        util::embedding::EmbeddingMatrix vectors(reader.Dimension(), batch_size);
+        std::vector<repositories::vector::VectorPoint> points;
+        points.reserve(batch_size);
+
+        const auto flush = [&]()
+        {
+            if (!points.empty())
+            {
+                vector_service.UpsertPoints(collection_name, points).ThrowErrorIfFailed();
+                points.clear();
+            }
+        };
+
+        ExportedPoint point;
+        uint64_t imported = 0;
+        while (reader.Next(point))
+        {
+            const util::embedding::RowView row = vectors.Row(points.size());
+            std::copy(point.vector.begin(), point.vector.end(), row.begin());
+            points.push_back(repositories::vector::VectorPoint{point.id, row, point.payload});
+            ++imported;
+            if (points.size() == batch_size)
+            {
+                flush();
+            }
+        }
+        flush();
+        return imported;
+    }
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CollectionScroller.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace indexing
+{
+    // Export file layout, all integers and floats in host byte order (little-endian
+    // on every target we build for):
+    //   header  "RAGX", u32 version, u32 flags, u32 dimension, u64 point count
+    //   points  u64 id, then dimension x f32 if flags has kExportVectors,
+    //           then u32 length + payload JSON if flags has kExportPayloads
+    constexpr uint32_t kExportVersion = 1;
+    constexpr uint32_t kExportVectors = 1u << 0;
+    constexpr uint32_t kExportPayloads = 1u << 1;
+
+    struct ExportReport
+    {
+        uint64_t points = 0;
+        uint32_t dimension = 0;
+        uint64_t bytes = 0;
+    };
+
+    // Streams every point of a collection into `filepath` through a CollectionScroller,
+    // so memory stays at two pages however large the collection is. The file is
+    // written under a temporary name and renamed once complete.
+    ExportReport ExportCollection(const services::vector::VectorService &vector_service,
+                                  const std::string &collection_name,
+                                  const std::string &filepath,
+                                  const ScrollOptions &options = {},
+                                  const util::context::RequestContext &context = util::context::RequestContext::Background());
+
+    struct ExportedPoint
+    {
+        repositories::vector::PointId id = 0;
+        std::vector<float> vector; // empty when the export has no vectors
+        std::string payload;       // empty when the export has no payloads
+    };
+
+    // Reads an export back one point at a time, reusing the caller's buffers
+    class ExportReader
+    {
+    private:
+        std::ifstream file;
+        uint32_t flags = 0;
+        uint32_t dimension = 0;
+        uint64_t point_count = 0;
+        uint64_t read = 0;
+        uint64_t file_size = 0;
+
+        // Lengths come from the file, so each is checked against what is left before allocating
+        void RequireBytes(uint64_t count);
+
+    public:
+        explicit ExportReader(const std::string &filepath);
+
+        bool HasVectors() const { return (flags & kExportVectors) != 0; }
+        bool HasPayloads() const { return (flags & kExportPayloads) != 0; }
+        uint32_t Dimension() const { return dimension; }
+        uint64_t PointCount() const { return point_count; }
+
+        // False after the last point; throws if the file ends early
+        bool Next(ExportedPoint &point);
+    };
+
+    // Upserts an export with vectors and payloads into a collection, creating it if
+    // needed, `batch_size` points per request. Returns the number of points written.
+    uint64_t ImportCollection(services::vector::VectorService &vector_service,
+                              const std::string &collection_name,
+                              const std::string &filepath,
+                              size_t batch_size = 256);
+};
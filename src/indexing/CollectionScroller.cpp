@@ -0,0 +1,109 @@
+#include "CollectionScroller.hpp"
+
+#include "util/trace/Tracer.hpp"
+
+namespace indexing
+{
+    CollectionScroller::CollectionScroller(const services::vector::VectorService &vector_service,
+                                           std::string collection_name,
+                                           ScrollOptions options,
+                                           util::context::RequestContext context)
+        : vector_service(vector_service),
+          collection_name(std::move(collection_name)),
+          options(std::move(options)),
+          context(std::move(context))
+    {
+        if (this->options.page_size == 0)
+        {
+            throw std::runtime_error("Scroll page size must be at least 1");
+        }
+    }
+
+    repositories::vector::ScrollPage CollectionScroller::Fetch(std::optional<repositories::vector::PointId> offset) const
+    {
+        repositories::vector::ScrollRequest request;
+        request.limit = options.page_size;
+        request.offset = offset;
+        request.with_vector = options.with_vector;
+        request.with_payload = options.with_payload;
+        request.payload_fields = options.payload_fields;
+        return vector_service.ScrollPoints(collection_name, request, context);
+    }
+
+    const repositories::vector::ScrollPage *CollectionScroller::NextPage()
+    {
+        do
+        {
+            if (exhausted)
+            {
+                return nullptr;
+            }
+
+            started = true;
+            try
+            {
+                current.emplace(pending.valid() ? pending.get() : Fetch(std::nullopt));
+            }
+            catch (...)
+            {
+                // The offset to resume from is gone with the failed page
+                exhausted = true;
+                throw;
+            }
+            exhausted = !current->next_offset.has_value();
+            if (!exhausted)
+            {
+                pending = std::async(
+                    std::launch::async,
+                    [this, offset = *current->next_offset, trace_context = util::trace::CurrentContext()]()
+                    {
+                        util::trace::ScopedContext scope(trace_context);
+                        return Fetch(offset);
+                    });
+            }
+        } while (current->Size() == 0);
+        return &*current;
+    }
+
+    CollectionScroller::Iterator CollectionScroller::begin()
+    {
+        if (started)
+        {
+            throw std::runtime_error("A collection can only be scrolled once per scroller");
+        }
+        const repositories::vector::ScrollPage *page = NextPage();
+        return page != nullptr ? Iterator(this, page) : Iterator();
+    }
+
+    CollectionScroller::Iterator::Iterator(CollectionScroller *scroller, const repositories::vector::ScrollPage *page)
+        : scroller(scroller), page(page)
+    {
+        Load();
+    }
+
+    void CollectionScroller::Iterator::Load()
+    {
+        point.id = page->ids[row];
+        point.vector = page->vectors.Rows() > 0 ? page->vectors.Row(row) : util::embedding::ConstRowView();
+        point.payload = page->payloads.empty() ? std::string_view() : std::string_view(page->payloads[row]);
+    }
+
+    CollectionScroller::Iterator &CollectionScroller::Iterator::operator++()
+    {
+        if (++row < page->Size())
+        {
+            Load();
+            return *this;
+        }
+
+        page = scroller->NextPage();
+        row = 0;
+        if (page == nullptr)
+        {
+            *this = Iterator();
+            return *this;
+        }
+        Load();
+        return *this;
+    }
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "services/vector/VectorService.hpp"
+
+#include <future>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace indexing
+{
+    struct ScrollOptions
+    {
+        size_t page_size = 256;
+        bool with_vector = true;
+        bool with_payload = true;
+        std::vector<std::string> payload_fields; // only these payload keys, when non-empty
+    };
+
+    // A point of the current page; the views last until the scroller moves past it
+    struct ScrolledPoint
+    {
+        repositories::vector::PointId id;
+        util::embedding::ConstRowView vector; // empty without with_vector
+        std::string_view payload;             // JSON object; empty without with_payload
+    };
+
+    // Lazily walks a whole collection page by page, in id order. While the caller
+    // works through one page the next is already being fetched, so at most two
+    // pages are held at a time regardless of the collection's size.
+    class CollectionScroller
+    {
+    public:
+        CollectionScroller(const services::vector::VectorService &vector_service,
+                           std::string collection_name,
+                           ScrollOptions options = {},
+                           util::context::RequestContext context = util::context::RequestContext::Background());
+
+        CollectionScroller(const CollectionScroller &) = delete;
+        CollectionScroller &operator=(const CollectionScroller &) = delete;
+
+        // The next non-empty page, or nullptr once the collection is exhausted.
+        // Invalidates the previous page. Errors from a prefetch surface here.
+        const repositories::vector::ScrollPage *NextPage();
+
+        // Single-pass iteration over points, fetching pages as needed
+        class Iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = ScrolledPoint;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const ScrolledPoint *;
+            using reference = const ScrolledPoint &;
+
+            Iterator() = default;
+
+            reference operator*() const { return point; }
+            pointer operator->() const { return &point; }
+            Iterator &operator++();
+            bool operator==(const Iterator &other) const { return scroller == other.scroller && row == other.row; }
+            bool operator!=(const Iterator &other) const { return !(*this == other); }
+
+        private:
+            friend class CollectionScroller;
+            Iterator(CollectionScroller *scroller, const repositories::vector::ScrollPage *page);
+            void Load();
+
+            CollectionScroller *scroller = nullptr; // null at the end
+            const repositories::vector::ScrollPage *page = nullptr;
+            size_t row = 0;
+            ScrolledPoint point{};
+        };
+
+        // Starts the scroll; call once
+        Iterator begin();
+        Iterator end() { return Iterator(); }
+
+    private:
+        repositories::vector::ScrollPage Fetch(std::optional<repositories::vector::PointId> offset) const;
+
+        const services::vector::VectorService &vector_service;
+        std::string collection_name;
+        ScrollOptions options;
+        util::context::RequestContext context;
+
+        std::optional<repositories::vector::ScrollPage> current; // rebuilt per page; pages are not assignable
+        bool started = false;
+        bool exhausted = false;
+        // Declared last so a prefetch still in flight finishes before the rest goes away
+        std::future<repositories::vector::ScrollPage> pending;
+    };
+};
@@ -0,0 +1,269 @@
+#include "CollectionSync.hpp"
+
+#include "util/trace/Tracer.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+using json = nlohmann::json;
+
+namespace indexing
+{
+    namespace
+    {
+        constexpr const char *kManifestHeader = "rag-manifest 1";
+
+        uint64_t Fnv1a(const std::string &value)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (const unsigned char c : value)
+            {
+                hash ^= c;
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        struct PendingDocument
+        {
+            repositories::vector::PointId id;
+            uint64_t hash;
+            const SourceDocument *document;
+        };
+    }
+
+    repositories::vector::PointId DocumentId(const std::string &key)
+    {
+        return Fnv1a(key);
+    }
+
+    uint64_t ContentHash(const std::string &text)
+    {
+        // Seeded differently from ids so that a key equal to its text does not give id == hash
+        return Fnv1a("content:" + text);
+    }
+
+    std::optional<Manifest> LoadManifest(const std::string &filepath, const std::string &collection_name)
+    {
+        std::ifstream file(filepath);
+        if (!file.is_open())
+        {
+            return std::nullopt;
+        }
+
+        std::string header;
+        if (!std::getline(file, header) || header != std::string(kManifestHeader) + " " + collection_name)
+        {
+            return std::nullopt;
+        }
+
+        Manifest manifest;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty())
+            {
+                continue;
+            }
+
+            // A damaged manifest says nothing reliable about the collection
+            std::istringstream fields(line);
+            repositories::vector::PointId id;
+            uint64_t hash;
+            if (!(fields >> id >> hash))
+            {
+                return std::nullopt;
+            }
+            manifest[id] = hash;
+        }
+        return manifest;
+    }
+
+    void SaveManifest(const std::string &filepath, const std::string &collection_name, const Manifest &manifest)
+    {
+        const std::string temporary_path = filepath + ".tmp";
+        {
+            std::ofstream file(temporary_path, std::ios::trunc);
+            if (!file.is_open())
+            {
+                throw std::runtime_error("Could not write manifest: " + temporary_path);
+            }
+
+            file << kManifestHeader << " " << collection_name << "\n";
+            for (const auto &[id, hash] : manifest)
+            {
+                file << id << " " << hash << "\n";
+            }
+            if (!file.good())
+            {
+                throw std::runtime_error("Could not write manifest: " + temporary_path);
+            }
+        }
+
+        if (std::rename(temporary_path.c_str(), filepath.c_str()) != 0)
+        {
+            throw std::runtime_error("Could not replace manifest: " + filepath);
+        }
+    }
+
+    void InvalidateManifest(const std::string &filepath)
+    {
+        if (std::remove(filepath.c_str()) != 0 && std::ifstream(filepath).is_open())
+        {
+            throw std::runtime_error("Could not remove manifest: " + filepath);
+        }
+    }
+
+    SyncReport CollectionSync::Sync(const std::string &collection_name, const std::vector<SourceDocument> &documents) const
+    {
+        util::trace::ScopedSpan span("sync.collection", collection_name);
+        SyncReport report;
+
+        bool collection_exists = vector_service.GetCollection(collection_name).status_code == 200;
+        std::optional<Manifest> loaded = collection_exists && !options.rebuild
+                                             ? LoadManifest(options.manifest_path, collection_name)
+                                             : std::nullopt;
+        if (collection_exists && !loaded)
+        {
+            vector_service.DeleteCollection(collection_name).ThrowErrorIfFailed();
+            collection_exists = false;
+            report.rebuilt = true;
+        }
+        Manifest manifest = loaded ? std::move(*loaded) : Manifest{};
+
+        // Desired state, keyed by id; a later document with the same key replaces an earlier one
+        std::unordered_map<repositories::vector::PointId, PendingDocument> wanted;
+        for (const auto &document : documents)
+        {
+            const repositories::vector::PointId id = DocumentId(document.key);
+            const auto [it, inserted] = wanted.try_emplace(id, PendingDocument{id, ContentHash(document.text), &document});
+            if (!inserted)
+            {
+                if (it->second.document->key != document.key)
+                {
+                    throw std::runtime_error("Document keys collide on id " + std::to_string(id) + ": " + document.key);
+                }
+                it->second = PendingDocument{id, ContentHash(document.text), &document};
+            }
+        }
+
+        std::vector<PendingDocument> pending;
+        for (const auto &document : documents)
+        {
+            const PendingDocument &entry = wanted.at(DocumentId(document.key));
+            if (entry.document != &document)
+            {
+                continue;
+            }
+
+            const auto indexed = manifest.find(entry.id);
+            if (indexed == manifest.end())
+            {
+                ++report.added;
+                pending.push_back(entry);
+            }
+            else if (indexed->second != entry.hash)
+            {
+                ++report.updated;
+                pending.push_back(entry);
+            }
+            else
+            {
+                // Stored remotely already; the in-process keyword index starts empty on every run
+                ++report.unchanged;
+                vector_service.IndexDocument(collection_name, entry.id, document.text);
+            }
+        }
+
+        std::vector<repositories::vector::PointId> stale;
+        for (const auto &[id, hash] : manifest)
+        {
+            if (wanted.find(id) == wanted.end())
+            {
+                stale.push_back(id);
+            }
+        }
+        std::sort(stale.begin(), stale.end());
+
+        // Keep whatever was applied before a failure, so the next run resumes from there
+        try
+        {
+            const size_t embed_batch_size = std::max<size_t>(1, options.embed_batch_size);
+            for (size_t begin = 0; begin < pending.size(); begin += embed_batch_size)
+            {
+                const size_t end = std::min(pending.size(), begin + embed_batch_size);
+
+                std::vector<std::string> texts;
+                texts.reserve(end - begin);
+                for (size_t i = begin; i < end; ++i)
+                {
+                    texts.push_back(pending[i].document->text);
+                }
+                const util::embedding::EmbeddingMatrix embeddings = embedder_service.GetEmbeddings(texts);
+
+                if (!collection_exists)
+                {
+                    vector_service.CreateCollection(collection_name, static_cast<int>(embeddings.Dimension())).ThrowErrorIfFailed();
+                    collection_exists = true;
+                }
+
+                std::vector<repositories::vector::VectorPoint> points;
+                points.reserve(end - begin);
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const SourceDocument &document = *pending[i].document;
+                    points.push_back(repositories::vector::VectorPoint{pending[i].id,
+                                                                       embeddings.Row(i - begin),
+                                                                       json{{"text", document.text}, {"key", document.key}}.dump()});
+                }
+                vector_service.UpsertPoints(collection_name, points).ThrowErrorIfFailed();
+
+                for (size_t i = begin; i < end; ++i)
+                {
+                    manifest[pending[i].id] = pending[i].hash;
+                }
+            }
+
+            const size_t delete_batch_size = std::max<size_t>(1, options.delete_batch_size);
+            for (size_t begin = 0; begin < stale.size(); begin += delete_batch_size)
+            {
+                const std::vector<repositories::vector::PointId> ids(stale.begin() + begin,
+                                                                     stale.begin() + std::min(stale.size(), begin + delete_batch_size));
+                vector_service.DeletePoints(collection_name, ids).ThrowErrorIfFailed();
+                for (const auto id : ids)
+                {
+                    manifest.erase(id);
+                }
+                report.removed += ids.size();
+            }
+        }
+        catch (...)
+        {
+            // Keep the progress made so far, but never let a failed save hide why the sync failed
+            if (collection_exists)
+            {
+                try
+                {
+                    SaveManifest(options.manifest_path, collection_name, manifest);
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "Warning: " << e.what() << std::endl;
+                }
+            }
+            throw;
+        }
+
+        if (collection_exists)
+        {
+            SaveManifest(options.manifest_path, collection_name, manifest);
+        }
+        return report;
+    }
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "services/embedder/EmbedderService.hpp"
+#include "services/vector/VectorService.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace indexing
+{
+    struct SourceDocument
+    {
+        std::string key; // stable identity, e.g. a path or the text itself
+        std::string text;
+    };
+
+    struct SyncOptions
+    {
+        std::string manifest_path;
+        size_t embed_batch_size = 32;   // documents per embedding/upsert request
+        size_t delete_batch_size = 256; // ids per delete request
+        bool rebuild = false;           // drop the collection and re-index everything
+    };
+
+    struct SyncReport
+    {
+        size_t added = 0;
+        size_t updated = 0;
+        size_t removed = 0;
+        size_t unchanged = 0;
+        bool rebuilt = false;
+    };
+
+    // Point id -> content hash of the text that is stored under it
+    using Manifest = std::unordered_map<repositories::vector::PointId, uint64_t>;
+
+    // 64-bit FNV-1a; ids come from the document key, hashes from its text
+    repositories::vector::PointId DocumentId(const std::string &key);
+    uint64_t ContentHash(const std::string &text);
+
+    // Returns nullopt when the file is missing, damaged or belongs to another collection.
+    std::optional<Manifest> LoadManifest(const std::string &filepath, const std::string &collection_name);
+    // Writes to a temporary file and renames it over the old manifest.
+    void SaveManifest(const std::string &filepath, const std::string &collection_name, const Manifest &manifest);
+    // Deletes the manifest, so the next sync rebuilds a collection changed behind its back.
+    void InvalidateManifest(const std::string &filepath);
+
+    // Brings a collection in line with a document set using a local manifest of
+    // what was indexed last time: only new or changed documents are embedded and
+    // upserted, and documents that disappeared are deleted in batches.
+    class CollectionSync
+    {
+    private:
+        const services::embedder::EmbedderService &embedder_service;
+        services::vector::VectorService &vector_service;
+        SyncOptions options;
+
+    public:
+        CollectionSync(const services::embedder::EmbedderService &embedder_service,
+                       services::vector::VectorService &vector_service,
+                       SyncOptions options)
+            : embedder_service(embedder_service),
+              vector_service(vector_service),
+              options(std::move(options)) {}
+
+        // A collection without a matching manifest is rebuilt, since its contents are unknown.
+        // Documents sharing a key are indexed once, with the last text given.
+        SyncReport Sync(const std::string &collection_name, const std::vector<SourceDocument> &documents) const;
+    };
+};
@@ -1,9 +1,15 @@
 #include <iostream>
+#include <curl/curl.h>
 #include <nlohmann/json.hpp>
 
 #include "util/http_client/HttpClient.hpp"
 #include "util/env/EnvLoader.hpp"
+#include "util/trace/Tracer.hpp"
 
+#include <charconv>
+#include <chrono>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -14,44 +20,256 @@ using json = nlohmann::json;
 
 #include "repositories/vector/VectorRepository.hpp"
 #include "services/vector/VectorService.hpp"
+#include "services/vector/ShardedVectorService.hpp"
 
 #include "repositories/llm/LlmRepository.hpp"
 #include "services/llm/LlmService.hpp"
 
+#include "batch/BatchRunner.hpp"
+#include "indexing/CollectionExport.hpp"
+#include "indexing/CollectionSync.hpp"
+
+struct CommandLineOptions
+{
+    std::string batch_input;
+    std::string batch_output = "answers.jsonl";
+    batch::BatchOptions batch_options;
+    std::string trace_output;
+    std::string trace_format = "chrome";
+    bool rebuild = false;
+    std::chrono::milliseconds deadline{0}; // per query; 0 for none
+    std::string export_path;
+    std::string import_path;
+    std::string transfer_collection; // for --export/--import; the app's collection when empty
+    indexing::ScrollOptions export_options;
+};
+
+// The whole text must be a number; std::stoul would accept "12abc" and throw on "abc"
+template <typename T>
+bool parse_number(const std::string &text, T &value)
+{
+    const char *end = text.data() + text.size();
+    const auto [last, error] = std::from_chars(text.data(), end, value);
+    return error == std::errc() && last == end;
+}
+
+bool parse_command_line(int argc, char *argv[], CommandLineOptions &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+        const std::string value = argv[++i];
+
+        if (arg == "--batch")
+        {
+            options.batch_input = value;
+        }
+        else if (arg == "--output")
+        {
+            options.batch_output = value;
+        }
+        else if (arg == "--threads")
+        {
+            if (!parse_number(value, options.batch_options.thread_count) || options.batch_options.thread_count == 0)
+                return false;
+        }
+        else if (arg == "--batch-size")
+        {
+            if (!parse_number(value, options.batch_options.batch_size) || options.batch_options.batch_size == 0)
+                return false;
+        }
+        else if (arg == "--trace")
+        {
+            options.trace_output = value;
+        }
+        else if (arg == "--trace-format")
+        {
+            if (value != "chrome" && value != "otlp")
+                return false;
+            options.trace_format = value;
+        }
+        else if (arg == "--deadline")
+        {
+            std::chrono::milliseconds::rep milliseconds = 0;
+            if (!parse_number(value, milliseconds) || milliseconds < 0)
+                return false;
+            options.deadline = std::chrono::milliseconds(milliseconds);
+            options.batch_options.deadline = options.deadline;
+        }
+        else if (arg == "--export")
+        {
+            options.export_path = value;
+        }
+        else if (arg == "--import")
+        {
+            options.import_path = value;
+        }
+        else if (arg == "--collection")
+        {
+            options.transfer_collection = value;
+        }
+        else if (arg == "--export-vectors")
+        {
+            if (value != "yes" && value != "no")
+                return false;
+            options.export_options.with_vector = value == "yes";
+        }
+        else if (arg == "--export-payload")
+        {
+            // "all", "none" or a comma-separated list of payload keys
+            options.export_options.with_payload = value != "none";
+            options.export_options.payload_fields.clear();
+            if (value != "all" && value != "none")
+            {
+                std::istringstream fields(value);
+                std::string field;
+                while (std::getline(fields, field, ','))
+                {
+                    options.export_options.payload_fields.push_back(field);
+                }
+            }
+        }
+        else if (arg == "--sync")
+        {
+            if (value != "incremental" && value != "rebuild")
+                return false;
+            options.rebuild = value == "rebuild";
+        }
+        else if (arg == "--retrieval")
+        {
+            if (value == "dense")
+                options.batch_options.retrieval = batch::RetrievalMode::Dense;
+            else if (value == "lexical")
+                options.batch_options.retrieval = batch::RetrievalMode::Lexical;
+            else if (value == "hybrid")
+                options.batch_options.retrieval = batch::RetrievalMode::Hybrid;
+            else
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    // One transfer per run; the usage line offers them as alternatives
+    return options.export_path.empty() || options.import_path.empty();
+}
+
 void answer_query(
     const std::string &query,
     const services::embedder::EmbedderService &embedder_service,
     const services::vector::VectorService &vector_service,
     const services::llm::LlmService &llm_service,
-    const std::string &collection_name)
+    const std::string &collection_name,
+    const services::vector::ShardedVectorService *sharded_service,
+    std::chrono::milliseconds deadline)
 {
-    // Obtain embedding for query
-    std::cout << "Query: " << query << std::endl;
-    std::vector<float> embedding_vector = embedder_service.GetEmbedding(query);
-
-    // Search for documents with similar embeddings to that of the query
-    std::vector<repositories::vector::SearchResult> search_results = vector_service.SearchSimilar(collection_name, embedding_vector, 5);
-    std::vector<std::string> context_documents;
-    for (const auto &result : search_results)
+    util::trace::ScopedSpan span("answer_query", query);
+    const util::context::RequestContext context = deadline.count() > 0
+                                                      ? util::context::RequestContext::WithTimeout(deadline)
+                                                      : util::context::RequestContext::Background();
+
+    try
+    {
+        // Everything this query allocates lives here and is freed in one go on return
+        util::arena::RequestArena arena;
+
+        // Obtain embedding for query
+        std::cout << "Query: " << query << std::endl;
+        const util::embedding::EmbeddingMatrix embedding = embedder_service.GetEmbedding(query, context);
+
+        // Search for documents with similar embeddings or matching keywords
+        std::vector<repositories::vector::SearchResult> search_results;
+        if (sharded_service != nullptr)
+        {
+            // Dense hits from every shard, fused with the local keyword index; like the
+            // single-collection path, top-k shrinks as the deadline runs out
+            const int limit = services::vector::VectorService::AdaptLimit(5, context);
+            const services::vector::ShardedSearchResult sharded = sharded_service->SearchSimilar(embedding.Row(0), arena, limit, context);
+            if (sharded.Partial())
+            {
+                std::cout << "Partial results: " << sharded.answered << " of " << sharded_service->ShardCount() << " shards answered" << std::endl;
+            }
+            if (sharded_service->ServesOnly(collection_name))
+            {
+                search_results = services::vector::VectorService::FuseRankings(
+                    {sharded.results, vector_service.SearchLexical(collection_name, query, arena, limit)}, limit);
+            }
+            else
+            {
+                // The keyword index only covers this app's collection, and fusion keys on
+                // bare ids, so hits from other collections are used as merged
+                search_results = sharded.results;
+            }
+        }
+        else
+        {
+            search_results = vector_service.HybridSearch(collection_name, query, embedding.Row(0), arena, 5, context);
+        }
+        std::vector<std::string_view> context_documents;
+        for (const auto &result : search_results)
+        {
+            std::cout << "[" << result.id << " - " << result.score << "] " << result.payload << std::endl;
+            context_documents.push_back(result.payload);
+        }
+
+        // Generate answer using LLM based on retrieved context documents and the query
+        if (!context_documents.empty())
+        {
+            std::cout << "Generating answer with " << context_documents.size() << " context documents..."
+                      << std::endl;
+            std::string response = llm_service.GenerateAnswer(query, context_documents, arena, 128, context);
+            std::cout << "LLM Response Body: " << response << std::endl;
+        }
+    }
+    catch (const util::context::DeadlineExceeded &e)
     {
-        std::cout << "[" << result.id << " - " << result.score << "] " << result.payload << std::endl;
-        context_documents.push_back(result.payload);
+        // Whatever was still in flight has been abandoned
+        std::cout << "Gave up on query: " << e.what() << std::endl;
     }
+    return;
+}
 
-    // Generate answer using LLM based on retrieved context documents and the query
-    if (!context_documents.empty())
+void write_trace(const CommandLineOptions &options)
+{
+    if (options.trace_output.empty())
     {
-        std::cout << "Generating answer with " << context_documents.size() << " context documents..."
-                  << std::endl;
-        std::string response = llm_service.GenerateAnswer(query, context_documents);
-        std::cout << "LLM Response Body: " << response << std::endl;
+        return;
     }
 
-    return;
+    const bool written = options.trace_format == "otlp"
+                             ? util::trace::WriteOtlpJson(options.trace_output)
+                             : util::trace::WriteChromeTrace(options.trace_output);
+    if (!written)
+    {
+        std::cerr << "Error: Could not write trace to " << options.trace_output << std::endl;
+        return;
+    }
+    std::cout << "Wrote trace to " << options.trace_output << std::endl;
 }
 
-int main()
+int main(int argc, char *argv[])
 {
+    CommandLineOptions options;
+    if (!parse_command_line(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--batch queries.jsonl] [--output answers.jsonl] [--threads N] [--batch-size N]"
+                  << " [--retrieval dense|lexical|hybrid] [--trace trace.json] [--trace-format chrome|otlp]"
+                  << " [--sync incremental|rebuild] [--deadline MS]\n"
+                  << "       [--export FILE | --import FILE] [--collection NAME] [--export-vectors yes|no]"
+                  << " [--export-payload all|none|KEY,KEY]" << std::endl;
+        return 1;
+    }
+
+    // libcurl's global state must be initialised before any thread issues a request
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    util::trace::Enable(!options.trace_output.empty());
+
     // Load environment variables from .env file
     util::env::EnvLoader env_loader;
     if (!env_loader.Load(".env"))
@@ -65,8 +283,10 @@ int main()
     const std::string embedder_url = env_loader.Get("EMBEDDER_SERVICE_URL", "http://localhost:8081");
     const std::string vector_db_url = env_loader.Get("VECTOR_DB_URL", "http://localhost:6333");
 
-    util::http::HttpClient llm_client(llm_url);
-    util::http::HttpClient embedder_client(embedder_url);
+    // The model servers are stateless, so each may list several replicas
+    const util::http::BalancingPolicy balancing = util::http::ParseBalancingPolicy(env_loader.Get("REPLICA_BALANCING", "least-outstanding"));
+    util::http::HttpClient llm_client = util::http::HttpClient::FromUrlList(llm_url, balancing);
+    util::http::HttpClient embedder_client = util::http::HttpClient::FromUrlList(embedder_url, balancing);
     util::http::HttpClient vector_client(vector_db_url);
 
     repositories::llm::LlmRepository llm_repo(std::move(llm_client));
@@ -79,12 +299,61 @@ int main()
 
     const std::string collection_name = "test_collection";
 
-    // Check if collection exists and delete it for a clean slate
-    util::http::HttpResponse response = vector_service.GetCollection(collection_name);
-    if (response.status_code == 200)
+    // Optional fan-out over several Qdrant nodes and/or collections for query-time search
+    std::unique_ptr<services::vector::ShardedVectorService> sharded_service;
+    const std::string shard_spec = env_loader.Get("VECTOR_SHARDS", "");
+    if (!shard_spec.empty())
     {
-        std::cout << "Collection 'test_collection' already exists. Deleting it first..." << std::endl;
-        vector_service.DeleteCollection(collection_name);
+        std::vector<services::vector::Shard> shards = services::vector::ParseShards(shard_spec, collection_name);
+        services::vector::ShardedSearchOptions shard_options;
+        std::chrono::milliseconds::rep shard_deadline = 0;
+        if (!parse_number(env_loader.Get("VECTOR_SHARD_DEADLINE_MS", "250"), shard_deadline) || shard_deadline <= 0)
+        {
+            std::cerr << "Error: VECTOR_SHARD_DEADLINE_MS must be a positive number of milliseconds" << std::endl;
+            return 1;
+        }
+        shard_options.deadline = std::chrono::milliseconds(shard_deadline);
+        const std::string normalization = env_loader.Get("VECTOR_SHARD_NORMALIZATION", "");
+        shard_options.normalization = normalization.empty() ? services::vector::DefaultScoreNormalization(shards)
+                                                            : services::vector::ParseScoreNormalization(normalization);
+        sharded_service = std::make_unique<services::vector::ShardedVectorService>(std::move(shards), shard_options);
+    }
+
+    const std::string manifest_path = env_loader.Get("SYNC_MANIFEST", collection_name + ".manifest");
+
+    // Export/import mode: copy a collection to or from a file and exit
+    if (!options.export_path.empty() || !options.import_path.empty())
+    {
+        const std::string &transfer_collection = options.transfer_collection.empty() ? collection_name : options.transfer_collection;
+        int status = 0;
+        try
+        {
+            if (!options.export_path.empty())
+            {
+                const indexing::ExportReport exported = indexing::ExportCollection(vector_service, transfer_collection, options.export_path, options.export_options);
+                std::cout << "Exported " << exported.points << " points (" << exported.bytes << " bytes) from '"
+                          << transfer_collection << "' to " << options.export_path << std::endl;
+            }
+            else
+            {
+                const uint64_t imported = indexing::ImportCollection(vector_service, transfer_collection, options.import_path);
+                // The manifest no longer describes the collection; points it does not list
+                // would be searchable but missing from the keyword index
+                if (transfer_collection == collection_name)
+                {
+                    indexing::InvalidateManifest(manifest_path);
+                }
+                std::cout << "Imported " << imported << " points into '" << transfer_collection << "' from " << options.import_path << std::endl;
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            status = 1;
+        }
+        write_trace(options);
+        curl_global_cleanup();
+        return status;
     }
 
     // Example usage, set of documents to index and query
@@ -104,33 +373,53 @@ int main()
         "Corporate knowledge articles are often tagged incorrectly and hard to find.",
     };
 
-    // Obtain embeddings for documents
-    // std::string -> std::vector<float>
-    std::vector<repositories::vector::VectorPoint> points;
+    // The text doubles as the key, so an edited document replaces its old point
+    std::vector<indexing::SourceDocument> sources;
     std::cout << "Collection contents:" << std::endl;
-    for (int idx = 0; idx < documents.size(); ++idx)
+    for (const auto &doc : documents)
     {
-        const std::string &doc = documents[idx];
-        std::cout << "[" << idx << "]\t" << doc << std::endl;
-        std::vector<float> embedding_vector = embedder_service.GetEmbedding(doc);
-        std::string j = json{{"text", doc}}.dump();
-        points.push_back(repositories::vector::VectorPoint{idx, embedding_vector, j});
+        std::cout << "[" << indexing::DocumentId(doc) << "]\t" << doc << std::endl;
+        sources.push_back(indexing::SourceDocument{doc, doc});
     }
 
-    // Create collection
-    response = vector_service.CreateCollection(collection_name, points[0].vector.size());
-    vector_service.UpsertPoints(collection_name, points);
+    // Only embed and upsert what changed since the last run
+    indexing::SyncOptions sync_options;
+    sync_options.manifest_path = manifest_path;
+    sync_options.rebuild = options.rebuild;
+    const indexing::CollectionSync collection_sync(embedder_service, vector_service, sync_options);
+    const indexing::SyncReport report = collection_sync.Sync(collection_name, sources);
+    std::cout << "Synced '" << collection_name << "'" << (report.rebuilt ? " (rebuilt)" : "") << ": "
+              << report.added << " added, " << report.updated << " updated, "
+              << report.removed << " removed, " << report.unchanged << " unchanged" << std::endl;
+
+    // Batch mode: answer every query from the input file and exit
+    if (!options.batch_input.empty())
+    {
+        const std::vector<batch::BatchQuery> queries = batch::LoadQueries(options.batch_input);
+        std::cout << "Running " << queries.size() << " queries from " << options.batch_input << "..." << std::endl;
+
+        const batch::BatchRunner runner(embedder_service, vector_service, llm_service, options.batch_options);
+        const std::vector<batch::BatchAnswer> answers = runner.Run(collection_name, queries);
+        batch::WriteAnswers(options.batch_output, answers);
+
+        std::cout << "Wrote " << answers.size() << " answers to " << options.batch_output << std::endl;
+        write_trace(options);
+        curl_global_cleanup();
+        return 0;
+    }
 
     // Queries
     std::cout << std::endl;
     std::cout << "########## QUERY 1 ##########" << std::endl;
     std::string query = "What is RAG and why is it useful in corporate?";
-    answer_query(query, embedder_service, vector_service, llm_service, collection_name);
+    answer_query(query, embedder_service, vector_service, llm_service, collection_name, sharded_service.get(), options.deadline);
 
     std::cout << std::endl;
     std::cout << "########## QUERY 2 ##########" << std::endl;
     query = "Who are the members of my team and what are they known for?";
-    answer_query(query, embedder_service, vector_service, llm_service, collection_name);
+    answer_query(query, embedder_service, vector_service, llm_service, collection_name, sharded_service.get(), options.deadline);
 
+    write_trace(options);
+    curl_global_cleanup();
     return 0;
 };
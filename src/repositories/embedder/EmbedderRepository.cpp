@@ -1,14 +1,27 @@
 #include "EmbedderRepository.hpp"
 
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
 namespace repositories
 {
     namespace embedder
     {
-        util::http::HttpResponse EmbedderRepository::GetEmbedding(const std::string &input) const
+        util::http::HttpResponse EmbedderRepository::GetEmbedding(const std::string &input, const util::context::RequestContext &context) const
         {
             const std::string path = "/v1/embeddings";
             const std::string json_body = "{\"input\": \"" + input + "\"}";
-            return http_client.Post(path, json_body);
+            return http_client.Post(path, json_body, context);
+        }
+
+        util::http::HttpResponse EmbedderRepository::GetEmbeddings(const std::vector<std::string> &inputs,
+                                                                       const util::context::RequestContext &context) const
+        {
+            const std::string path = "/v1/embeddings";
+            json request_json;
+            request_json["input"] = inputs;
+            return http_client.Post(path, request_json.dump(), context);
         }
     }
 };
@@ -2,6 +2,9 @@
 
 #include "util/http_client/HttpClient.hpp"
 
+#include <string>
+#include <vector>
+
 namespace repositories
 {
     namespace embedder
@@ -15,7 +18,10 @@ namespace repositories
             explicit EmbedderRepository(util::http::HttpClient client) : http_client(
                                                                              std::move(client)) {}
 
-            util::http::HttpResponse GetEmbedding(const std::string &input) const;
+            util::http::HttpResponse GetEmbedding(const std::string &input,
+                                                  const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+            util::http::HttpResponse GetEmbeddings(const std::vector<std::string> &inputs,
+                                                   const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
         };
     }
 };
@@ -0,0 +1,228 @@
+#include "InvertedIndex.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace repositories
+{
+    namespace lexical
+    {
+        namespace
+        {
+            // Dead ordinals tolerated before compaction is considered at all
+            constexpr size_t kMinDeadForCompaction = 64;
+
+            bool IsTermByte(unsigned char c)
+            {
+                return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+            }
+
+            void AppendVarint(std::vector<uint8_t> &bytes, uint32_t value)
+            {
+                while (value >= 0x80)
+                {
+                    bytes.push_back(static_cast<uint8_t>(value | 0x80));
+                    value >>= 7;
+                }
+                bytes.push_back(static_cast<uint8_t>(value));
+            }
+
+            uint32_t ReadVarint(const uint8_t *&cursor)
+            {
+                uint32_t value = 0;
+                int shift = 0;
+                while (*cursor & 0x80)
+                {
+                    value |= static_cast<uint32_t>(*cursor++ & 0x7F) << shift;
+                    shift += 7;
+                }
+                value |= static_cast<uint32_t>(*cursor++) << shift;
+                return value;
+            }
+
+            std::unordered_map<std::string, uint32_t> CountTerms(const std::vector<std::string> &terms)
+            {
+                std::unordered_map<std::string, uint32_t> counts;
+                for (const auto &term : terms)
+                {
+                    ++counts[term];
+                }
+                return counts;
+            }
+        }
+
+        std::vector<std::string> Tokenize(const std::string &text)
+        {
+            std::vector<std::string> terms;
+            std::string current;
+            for (const char ch : text)
+            {
+                const auto c = static_cast<unsigned char>(ch);
+                if (IsTermByte(c))
+                {
+                    current.push_back(c < 0x80 ? static_cast<char>(std::tolower(c)) : ch);
+                }
+                else if (!current.empty())
+                {
+                    terms.push_back(std::move(current));
+                    current.clear();
+                }
+            }
+            if (!current.empty())
+            {
+                terms.push_back(std::move(current));
+            }
+            return terms;
+        }
+
+        void InvertedIndex::AddDocument(vector::PointId id, const std::string &text)
+        {
+            RemoveDocument(id);
+
+            const std::vector<std::string> terms = Tokenize(text);
+            const auto ordinal = static_cast<uint32_t>(documents.size());
+            documents.push_back(Document{id, text, static_cast<uint32_t>(terms.size()), true});
+            ordinal_by_id[id] = ordinal;
+            total_length += terms.size();
+            ++live_documents;
+
+            for (const auto &[term, frequency] : CountTerms(terms))
+            {
+                PostingList &list = postings[term];
+                AppendVarint(list.bytes, list.bytes.empty() ? ordinal : ordinal - list.last_ordinal);
+                AppendVarint(list.bytes, frequency);
+                list.last_ordinal = ordinal;
+                ++list.document_frequency;
+            }
+        }
+
+        bool InvertedIndex::RemoveDocument(vector::PointId id)
+        {
+            const auto it = ordinal_by_id.find(id);
+            if (it == ordinal_by_id.end())
+            {
+                return false;
+            }
+
+            // Postings keep the dead ordinal and are skipped while scoring; only the
+            // statistics BM25 depends on are corrected here.
+            Document &document = documents[it->second];
+            for (const auto &entry : CountTerms(Tokenize(document.text)))
+            {
+                --postings[entry.first].document_frequency;
+            }
+            total_length -= document.length;
+            --live_documents;
+            document.live = false;
+            document.text.clear();
+            document.text.shrink_to_fit();
+            ordinal_by_id.erase(it);
+
+            const size_t dead = documents.size() - live_documents;
+            if (dead >= kMinDeadForCompaction && dead > live_documents)
+            {
+                Compact();
+            }
+            return true;
+        }
+
+        void InvertedIndex::Compact()
+        {
+            // Re-adding in ordinal order keeps the relative order of the survivors
+            std::vector<Document> survivors;
+            survivors.reserve(live_documents);
+            for (auto &document : documents)
+            {
+                if (document.live)
+                {
+                    survivors.push_back(std::move(document));
+                }
+            }
+
+            Clear();
+            for (const auto &document : survivors)
+            {
+                AddDocument(document.id, document.text);
+            }
+        }
+
+        void InvertedIndex::Clear()
+        {
+            postings.clear();
+            documents.clear();
+            ordinal_by_id.clear();
+            total_length = 0;
+            live_documents = 0;
+        }
+
+        std::vector<vector::SearchResult> InvertedIndex::Search(const std::string &query, int limit, util::arena::RequestArena &arena) const
+        {
+            if (live_documents == 0 || limit <= 0)
+            {
+                return {};
+            }
+
+            const float document_count = static_cast<float>(live_documents);
+            const float average_length = static_cast<float>(total_length) / document_count;
+
+            // Term-at-a-time accumulation over the matching ordinals only
+            std::unordered_map<uint32_t, float> scores;
+            for (const auto &entry : CountTerms(Tokenize(query)))
+            {
+                const auto it = postings.find(entry.first);
+                if (it == postings.end() || it->second.document_frequency == 0)
+                {
+                    continue;
+                }
+
+                const PostingList &list = it->second;
+                const float df = static_cast<float>(list.document_frequency);
+                const float idf = std::log(1.0f + (document_count - df + 0.5f) / (df + 0.5f));
+
+                const uint8_t *cursor = list.bytes.data();
+                const uint8_t *end = cursor + list.bytes.size();
+                uint32_t ordinal = 0;
+                while (cursor < end)
+                {
+                    ordinal += ReadVarint(cursor);
+                    const float tf = static_cast<float>(ReadVarint(cursor));
+                    const Document &document = documents[ordinal];
+                    if (!document.live)
+                    {
+                        continue;
+                    }
+                    const float norm = k1 * (1.0f - b + b * static_cast<float>(document.length) / average_length);
+                    scores[ordinal] += idf * tf * (k1 + 1.0f) / (tf + norm);
+                }
+            }
+
+            // Min-heap holding the best `limit` candidates seen so far
+            using Candidate = std::pair<float, uint32_t>;
+            std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> top;
+            for (const auto &[ordinal, score] : scores)
+            {
+                if (top.size() < static_cast<size_t>(limit))
+                {
+                    top.emplace(score, ordinal);
+                }
+                else if (score > top.top().first)
+                {
+                    top.pop();
+                    top.emplace(score, ordinal);
+                }
+            }
+
+            std::vector<vector::SearchResult> results(top.size());
+            for (size_t i = results.size(); i > 0; --i)
+            {
+                const Document &document = documents[top.top().second];
+                results[i - 1] = vector::SearchResult{document.id, top.top().first, arena.Copy(document.text)};
+                top.pop();
+            }
+            return results;
+        }
+    }
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "repositories/vector/VectorRepository.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace repositories
+{
+    namespace lexical
+    {
+        // Lower-cased alphanumeric terms; bytes >= 0x80 are kept so UTF-8 words stay whole.
+        std::vector<std::string> Tokenize(const std::string &text);
+
+        // BM25 inverted index over document texts. Postings are stored as
+        // varint-encoded (doc ordinal delta, term frequency) pairs; ordinals only
+        // grow, so new documents are appended to the compressed lists directly.
+        // Removed documents stay behind as dead ordinals until they make up half
+        // the index, at which point the live ones are re-indexed from scratch.
+        class InvertedIndex
+        {
+        public:
+            explicit InvertedIndex(float k1 = 1.2f, float b = 0.75f) : k1(k1), b(b) {}
+
+            // Adds a document, replacing any previous document with the same id.
+            void AddDocument(vector::PointId id, const std::string &text);
+            bool RemoveDocument(vector::PointId id);
+            void Clear();
+
+            // Matching texts are copied into the arena, so results outlive later index updates
+            std::vector<vector::SearchResult> Search(const std::string &query, int limit, util::arena::RequestArena &arena) const;
+
+            size_t Size() const { return live_documents; }
+
+        private:
+            struct PostingList
+            {
+                std::vector<uint8_t> bytes;
+                uint32_t last_ordinal = 0;
+                uint32_t document_frequency = 0;
+            };
+
+            struct Document
+            {
+                vector::PointId id;
+                std::string text;
+                uint32_t length;
+                bool live;
+            };
+
+            void Compact();
+
+            float k1;
+            float b;
+            std::unordered_map<std::string, PostingList> postings;
+            std::vector<Document> documents;
+            std::unordered_map<vector::PointId, uint32_t> ordinal_by_id;
+            uint64_t total_length = 0;
+            size_t live_documents = 0;
+        };
+    }
+};
@@ -0,0 +1,45 @@
+#include "LexicalRepository.hpp"
+
+#include <mutex>
+
+namespace repositories
+{
+    namespace lexical
+    {
+        void LexicalRepository::AddDocument(const std::string &collection_name, vector::PointId id, const std::string &text)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            indexes[collection_name].AddDocument(id, text);
+        }
+
+        void LexicalRepository::RemoveDocument(const std::string &collection_name, vector::PointId id)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            const auto it = indexes.find(collection_name);
+            if (it != indexes.end())
+            {
+                it->second.RemoveDocument(id);
+            }
+        }
+
+        void LexicalRepository::DropCollection(const std::string &collection_name)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            indexes.erase(collection_name);
+        }
+
+        std::vector<vector::SearchResult> LexicalRepository::Search(const std::string &collection_name,
+                                                                    const std::string &query,
+                                                                    util::arena::RequestArena &arena,
+                                                                    int limit) const
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            const auto it = indexes.find(collection_name);
+            if (it == indexes.end())
+            {
+                return {};
+            }
+            return it->second.Search(query, limit, arena);
+        }
+    }
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "repositories/lexical/InvertedIndex.hpp"
+
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace repositories
+{
+    namespace lexical
+    {
+        // In-process keyword store mirroring the payload texts of each vector
+        // collection. Searches may run concurrently with each other; writers are exclusive.
+        class LexicalRepository
+        {
+        private:
+            std::map<std::string, InvertedIndex> indexes;
+            mutable std::shared_mutex mutex;
+
+        public:
+            LexicalRepository() = default;
+
+            void AddDocument(const std::string &collection_name, vector::PointId id, const std::string &text);
+            void RemoveDocument(const std::string &collection_name, vector::PointId id);
+            void DropCollection(const std::string &collection_name);
+
+            std::vector<vector::SearchResult> Search(const std::string &collection_name,
+                                                     const std::string &query,
+                                                     util::arena::RequestArena &arena,
+                                                     int limit = 10) const;
+        };
+    }
+};
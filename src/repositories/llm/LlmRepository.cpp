@@ -1,5 +1,6 @@
 #include "./LlmRepository.hpp"
-#include <sstream>
+#include <charconv>
+#include <cstring>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
@@ -8,16 +9,136 @@ namespace repositories
 {
     namespace llm
     {
-        std::string LlmRepository::GenerateCompletion(const std::string &prompt, unsigned int max_tokens) const
+        namespace
         {
-            const std::string path = "/v1/completions";
+            size_t EscapedSize(std::string_view text)
+            {
+                size_t size = 0;
+                for (const char ch : text)
+                {
+                    const auto c = static_cast<unsigned char>(ch);
+                    if (c == '"' || c == '\\' || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t')
+                        size += 2;
+                    else if (c < 0x20)
+                        size += 6;
+                    else
+                        size += 1;
+                }
+                return size;
+            }
+
+            char *AppendEscaped(char *out, std::string_view text)
+            {
+                static const char hex[] = "0123456789abcdef";
+                for (const char ch : text)
+                {
+                    const auto c = static_cast<unsigned char>(ch);
+                    switch (c)
+                    {
+                    case '"':
+                        *out++ = '\\';
+                        *out++ = '"';
+                        break;
+                    case '\\':
+                        *out++ = '\\';
+                        *out++ = '\\';
+                        break;
+                    case '\b':
+                        *out++ = '\\';
+                        *out++ = 'b';
+                        break;
+                    case '\f':
+                        *out++ = '\\';
+                        *out++ = 'f';
+                        break;
+                    case '\n':
+                        *out++ = '\\';
+                        *out++ = 'n';
+                        break;
+                    case '\r':
+                        *out++ = '\\';
+                        *out++ = 'r';
+                        break;
+                    case '\t':
+                        *out++ = '\\';
+                        *out++ = 't';
+                        break;
+                    default:
+                        if (c < 0x20)
+                        {
+                            std::memcpy(out, "\\u00", 4);
+                            out[4] = hex[c >> 4];
+                            out[5] = hex[c & 0x0F];
+                            out += 6;
+                        }
+                        else
+                        {
+                            *out++ = ch;
+                        }
+                    }
+                }
+                return out;
+            }
+
+            char *AppendRaw(char *out, std::string_view text)
+            {
+                std::memcpy(out, text.data(), text.size());
+                return out + text.size();
+            }
+        }
 
-            json request_json;
-            request_json["prompt"] = prompt;
-            request_json["n_predict"] = max_tokens;
-            request_json["temperature"] = 0.7;
+        std::string_view LlmRepository::SerializeCompletionRequest(const std::pmr::vector<std::string_view> &prompt_fragments,
+                                                                   unsigned int max_tokens,
+                                                                   util::arena::RequestArena &arena)
+        {
+            constexpr std::string_view prefix = "{\"prompt\":\"";
+            constexpr std::string_view middle = "\",\"n_predict\":";
+            constexpr std::string_view suffix = ",\"temperature\":0.7}";
 
-            util::http::HttpResponse response = http_client.Post(path, request_json.dump());
+            char tokens[16];
+            const auto tokens_end = std::to_chars(tokens, tokens + sizeof(tokens), max_tokens).ptr;
+            const std::string_view tokens_text(tokens, static_cast<size_t>(tokens_end - tokens));
+
+            // Size the body exactly, then write it once
+            size_t size = prefix.size() + middle.size() + tokens_text.size() + suffix.size();
+            for (const auto &fragment : prompt_fragments)
+            {
+                size += EscapedSize(fragment);
+            }
+
+            char *body = static_cast<char *>(arena.allocate(size, alignof(char)));
+            char *out = AppendRaw(body, prefix);
+            for (const auto &fragment : prompt_fragments)
+            {
+                out = AppendEscaped(out, fragment);
+            }
+            out = AppendRaw(out, middle);
+            out = AppendRaw(out, tokens_text);
+            AppendRaw(out, suffix);
+            return std::string_view(body, size);
+        }
+
+        std::string LlmRepository::GenerateCompletion(const std::string &prompt,
+                                                      unsigned int max_tokens,
+                                                      const util::context::RequestContext &context) const
+        {
+            util::arena::RequestArena arena;
+            std::pmr::vector<std::string_view> prompt_fragments({prompt}, &arena);
+            return GenerateCompletion(prompt_fragments, arena, max_tokens, context);
+        }
+
+        std::string LlmRepository::GenerateCompletion(const std::pmr::vector<std::string_view> &prompt_fragments,
+                                                      util::arena::RequestArena &arena,
+                                                      unsigned int max_tokens,
+                                                      const util::context::RequestContext &context) const
+        {
+            const std::string path = "/v1/completions";
+
+            util::http::HttpResponse response = http_client.Post(path, SerializeCompletionRequest(prompt_fragments, max_tokens, arena), context);
+            if (response.status_code == 0)
+            {
+                context.ThrowIfDone("llm.completion");
+            }
             response.ThrowErrorIfFailed();
 
             json response_json = json::parse(response.body);
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "util/http_client/HttpClient.hpp"
+#include "util/arena/RequestArena.hpp"
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace repositories
 {
@@ -15,7 +19,20 @@ namespace repositories
         public:
             explicit LlmRepository(util::http::HttpClient client) : http_client(std::move(client)) {}
 
-            std::string GenerateCompletion(const std::string &prompt, unsigned int max_tokens = 512) const;
+            std::string GenerateCompletion(const std::string &prompt,
+                                           unsigned int max_tokens = 512,
+                                           const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            // The prompt is the concatenation of the fragments; the request body is
+            // escaped from them directly into a single arena buffer.
+            std::string GenerateCompletion(const std::pmr::vector<std::string_view> &prompt_fragments,
+                                           util::arena::RequestArena &arena,
+                                           unsigned int max_tokens = 512,
+                                           const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            static std::string_view SerializeCompletionRequest(const std::pmr::vector<std::string_view> &prompt_fragments,
+                                                               unsigned int max_tokens,
+                                                               util::arena::RequestArena &arena);
         };
     }
 }
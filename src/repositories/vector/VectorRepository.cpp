@@ -1,4 +1,5 @@
 #include "VectorRepository.hpp"
+#include <charconv>
 #include <sstream>
 #include <nlohmann/json.hpp>
 
@@ -8,6 +9,591 @@ namespace repositories
 {
     namespace vector
     {
+        namespace
+        {
+            // Shortest text that parses back to the same float; the stream default keeps only 6 digits
+            void WriteFloat(std::ostringstream &json_body, float value)
+            {
+                char buffer[32];
+                const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                json_body.write(buffer, end - buffer);
+            }
+
+            void WritePoint(std::ostringstream &json_body, const VectorPoint &point)
+            {
+                json_body << "{\"id\":" << point.id << ",\"vector\":[";
+
+                for (size_t i = 0; i < point.vector.size(); ++i)
+                {
+                    if (i > 0)
+                        json_body << ",";
+                    WriteFloat(json_body, point.vector[i]);
+                }
+
+                json_body << "],\"payload\":" << point.payload << "}";
+            }
+
+            void WriteSearchRequest(std::ostringstream &json_body, util::embedding::ConstRowView query_vector, int limit)
+            {
+                json_body << "{\"vector\":[";
+
+                for (size_t i = 0; i < query_vector.size(); ++i)
+                {
+                    if (i > 0)
+                        json_body << ",";
+                    WriteFloat(json_body, query_vector[i]);
+                }
+
+                json_body << "],\"limit\":" << limit << ",\"with_payload\":true}";
+            }
+
+            // Streams a Qdrant search (or batch search) response straight into
+            // SearchResults without building a DOM; payload texts are copied once,
+            // into the request arena.
+            class SearchResponseHandler : public nlohmann::json_sax<json>
+            {
+            public:
+                SearchResponseHandler(util::arena::RequestArena &arena, bool batched)
+                    : arena(arena), point_depth(batched ? 4 : 3), batched(batched) {}
+
+                std::vector<std::vector<SearchResult>> results;
+                bool saw_result = false;
+                std::string error; // why a well-formed response was rejected
+
+                bool null() override { return NotId(); }
+                bool boolean(bool) override { return NotId(); }
+                bool number_integer(number_integer_t value) override
+                {
+                    if (value >= 0)
+                    {
+                        return number_unsigned(static_cast<number_unsigned_t>(value));
+                    }
+                    return NotId() && Number(static_cast<double>(value));
+                }
+                bool number_unsigned(number_unsigned_t value) override { return Integer(static_cast<PointId>(value), static_cast<double>(value)); }
+                bool number_float(number_float_t value, const string_t &) override { return NotId() && Number(value); }
+                bool binary(binary_t &) override { return NotId(); }
+
+                bool string(string_t &value) override
+                {
+                    if (InPayload() && frames.back().key == Key::Text)
+                    {
+                        results.back().back().payload = arena.Copy(value);
+                        has_text = true;
+                    }
+                    return NotId();
+                }
+
+                bool start_object(std::size_t) override
+                {
+                    if (!NotId())
+                    {
+                        return false;
+                    }
+                    frames.push_back(Frame{false, Key::Other});
+                    if (InPoint())
+                    {
+                        results.back().push_back(SearchResult{0, 0.0f, {}});
+                        has_id = has_score = has_text = false;
+                    }
+                    return true;
+                }
+
+                bool key(string_t &value) override
+                {
+                    Key key = Key::Other;
+                    if (frames.size() == 1 && value == "result")
+                        key = Key::Result;
+                    else if (value == "id")
+                        key = Key::Id;
+                    else if (value == "score")
+                        key = Key::Score;
+                    else if (value == "payload")
+                        key = Key::Payload;
+                    else if (value == "text")
+                        key = Key::Text;
+                    frames.back().key = key;
+                    return true;
+                }
+
+                bool end_object() override
+                {
+                    const bool closing_point = InPoint();
+                    frames.pop_back();
+                    if (closing_point && !(has_id && has_score && has_text))
+                    {
+                        error = !has_id ? "Hit without an id" : !has_score ? "Hit without a score" : "Hit without payload text";
+                        return false;
+                    }
+                    return true;
+                }
+
+                bool start_array(std::size_t) override
+                {
+                    if (!NotId())
+                    {
+                        return false;
+                    }
+                    frames.push_back(Frame{true, Key::Other});
+                    if (frames.size() == 2 && frames[0].key == Key::Result)
+                    {
+                        saw_result = true;
+                        if (!batched)
+                        {
+                            results.emplace_back();
+                        }
+                    }
+                    else if (batched && frames.size() == 3 && InResult())
+                    {
+                        results.emplace_back();
+                    }
+                    return true;
+                }
+
+                bool end_array() override
+                {
+                    frames.pop_back();
+                    return true;
+                }
+
+                bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &) override
+                {
+                    return false;
+                }
+
+            private:
+                enum class Key
+                {
+                    Other,
+                    Result,
+                    Id,
+                    Score,
+                    Payload,
+                    Text,
+                };
+
+                struct Frame
+                {
+                    bool is_array;
+                    Key key;
+                };
+
+                bool InResult() const
+                {
+                    return frames.size() >= 2 && frames[0].key == Key::Result && frames[1].is_array;
+                }
+
+                bool InPoint() const
+                {
+                    return frames.size() == point_depth && !frames.back().is_array && InResult() &&
+                           frames[point_depth - 2].is_array;
+                }
+
+                bool InPayload() const
+                {
+                    return frames.size() == point_depth + 1 && !frames.back().is_array && InResult() &&
+                           frames[point_depth - 1].key == Key::Payload && !results.empty() && !results.back().empty();
+                }
+
+                // Ids are taken from the integer token itself; a double cannot hold every 64-bit id
+                bool Integer(PointId id, double value)
+                {
+                    if (InPoint() && frames.back().key == Key::Id)
+                    {
+                        results.back().back().id = id;
+                        has_id = true;
+                        return true;
+                    }
+                    return Number(value);
+                }
+
+                bool Number(double value)
+                {
+                    if (InPoint() && frames.back().key == Key::Score)
+                    {
+                        results.back().back().score = static_cast<float>(value);
+                        has_score = true;
+                    }
+                    return true;
+                }
+
+                // Any id token other than an unsigned integer rejects the response
+                bool NotId()
+                {
+                    if (InPoint() && frames.back().key == Key::Id)
+                    {
+                        error = "Only unsigned integer point ids are supported";
+                        return false;
+                    }
+                    return true;
+                }
+
+                util::arena::RequestArena &arena;
+                size_t point_depth;
+                bool batched;
+                std::vector<Frame> frames;
+                bool has_id = false;
+                bool has_score = false;
+                bool has_text = false;
+            };
+
+            // Re-emits the JSON events of one payload object as compact text. Numbers
+            // keep their original spelling, so nothing is lost to a double round trip.
+            class PayloadWriter
+            {
+            public:
+                void Begin(std::string *target)
+                {
+                    out = target;
+                    first.clear();
+                    after_key = false;
+                }
+
+                void Open(char bracket)
+                {
+                    Separator();
+                    out->push_back(bracket);
+                    first.push_back(true);
+                }
+
+                void Close(char bracket)
+                {
+                    out->push_back(bracket);
+                    first.pop_back();
+                }
+
+                void Key(const std::string &key)
+                {
+                    Separator();
+                    String(key);
+                    out->push_back(':');
+                    after_key = true;
+                }
+
+                void Scalar(std::string_view text)
+                {
+                    Separator();
+                    out->append(text);
+                }
+
+                void Text(const std::string &value)
+                {
+                    Separator();
+                    String(value);
+                }
+
+            private:
+                void Separator()
+                {
+                    if (after_key)
+                    {
+                        after_key = false;
+                    }
+                    else if (!first.empty())
+                    {
+                        if (!first.back())
+                            out->push_back(',');
+                        first.back() = false;
+                    }
+                }
+
+                void String(const std::string &value)
+                {
+                    static const char hex[] = "0123456789abcdef";
+                    out->push_back('"');
+                    for (const char ch : value)
+                    {
+                        const auto c = static_cast<unsigned char>(ch);
+                        if (c == '"' || c == '\\')
+                        {
+                            out->push_back('\\');
+                            out->push_back(ch);
+                        }
+                        else if (c < 0x20)
+                        {
+                            out->append("\\u00");
+                            out->push_back(hex[c >> 4]);
+                            out->push_back(hex[c & 0x0F]);
+                        }
+                        else
+                        {
+                            out->push_back(ch);
+                        }
+                    }
+                    out->push_back('"');
+                }
+
+                std::string *out = nullptr;
+                std::vector<bool> first; // per open container: nothing written into it yet
+                bool after_key = false;
+            };
+
+            // Streams a Qdrant scroll response into a ScrollPage: vectors go straight
+            // into the page's matrix and payloads are re-serialized without a DOM.
+            class ScrollResponseHandler : public nlohmann::json_sax<json>
+            {
+            public:
+                std::vector<PointId> ids;
+                std::optional<util::embedding::EmbeddingMatrix> vectors; // built at the first vector's size
+                std::vector<std::string> payloads;
+                std::optional<PointId> next_offset;
+                bool saw_points = false;
+                std::string error; // why a well-formed response was rejected
+
+                bool null() override
+                {
+                    if (in_payload)
+                        payload.Scalar("null");
+                    return true;
+                }
+
+                bool boolean(bool value) override
+                {
+                    if (in_payload)
+                        payload.Scalar(value ? "true" : "false");
+                    return true;
+                }
+
+                bool number_integer(number_integer_t value) override
+                {
+                    if (value >= 0)
+                    {
+                        return number_unsigned(static_cast<number_unsigned_t>(value));
+                    }
+                    return Number(static_cast<double>(value), std::to_string(value));
+                }
+
+                bool number_unsigned(number_unsigned_t value) override
+                {
+                    if (AtPointKey(Key::Id))
+                    {
+                        ids.back() = static_cast<PointId>(value);
+                        has_id = true;
+                        return true;
+                    }
+                    if (frames.size() == 2 && InResult() && frames.back().key == Key::NextOffset)
+                    {
+                        next_offset = static_cast<PointId>(value);
+                        return true;
+                    }
+                    return Number(static_cast<double>(value), std::to_string(value));
+                }
+
+                bool number_float(number_float_t value, const string_t &text) override
+                {
+                    return Number(value, text);
+                }
+
+                bool string(string_t &value) override
+                {
+                    if (in_payload)
+                    {
+                        payload.Text(value);
+                        return true;
+                    }
+                    if (AtPointKey(Key::Id))
+                    {
+                        error = "Only unsigned integer point ids are supported";
+                        return false;
+                    }
+                    return true;
+                }
+
+                bool binary(binary_t &) override { return true; }
+
+                bool start_object(std::size_t) override
+                {
+                    if (in_payload)
+                    {
+                        payload.Open('{');
+                    }
+                    else if (AtPointKey(Key::Payload))
+                    {
+                        in_payload = true;
+                        payload.Begin(&payloads.emplace_back());
+                        payload.Open('{');
+                    }
+                    else if (AtPointKey(Key::Vector))
+                    {
+                        error = "Named vectors are not supported";
+                        return false;
+                    }
+
+                    frames.push_back(Frame{false, Key::Other});
+                    if (InPoint())
+                    {
+                        ids.push_back(0);
+                        has_id = false;
+                    }
+                    return true;
+                }
+
+                bool key(string_t &value) override
+                {
+                    if (in_payload)
+                    {
+                        payload.Key(value);
+                        return true;
+                    }
+
+                    Key key = Key::Other;
+                    if (frames.size() == 1 && value == "result")
+                        key = Key::Result;
+                    else if (frames.size() == 2 && value == "points")
+                        key = Key::Points;
+                    else if (frames.size() == 2 && value == "next_page_offset")
+                        key = Key::NextOffset;
+                    else if (InPoint() && value == "id")
+                        key = Key::Id;
+                    else if (InPoint() && value == "vector")
+                        key = Key::Vector;
+                    else if (InPoint() && value == "payload")
+                        key = Key::Payload;
+                    frames.back().key = key;
+                    return true;
+                }
+
+                bool end_object() override
+                {
+                    const bool closing_point = InPoint();
+                    frames.pop_back();
+                    if (in_payload)
+                    {
+                        payload.Close('}');
+                        in_payload = frames.size() > kPointDepth;
+                    }
+                    else if (closing_point && !has_id)
+                    {
+                        error = "Point without an id";
+                        return false;
+                    }
+                    return true;
+                }
+
+                bool start_array(std::size_t) override
+                {
+                    if (in_payload)
+                    {
+                        payload.Open('[');
+                    }
+                    else if (in_vector)
+                    {
+                        error = "Multi-vectors are not supported";
+                        return false;
+                    }
+                    else if (AtPointKey(Key::Vector))
+                    {
+                        in_vector = true;
+                        scratch.clear();
+                    }
+
+                    frames.push_back(Frame{true, Key::Other});
+                    if (frames.size() == 3 && InResult() && frames[1].key == Key::Points)
+                    {
+                        saw_points = true;
+                    }
+                    return true;
+                }
+
+                bool end_array() override
+                {
+                    frames.pop_back();
+                    if (in_payload)
+                    {
+                        payload.Close(']');
+                    }
+                    else if (in_vector)
+                    {
+                        in_vector = false;
+                        if (!vectors)
+                        {
+                            vectors.emplace(scratch.size());
+                        }
+                        else if (scratch.size() != vectors->Dimension())
+                        {
+                            error = "Mixed vector sizes";
+                            return false;
+                        }
+                        vectors->AppendRow(scratch);
+                    }
+                    return true;
+                }
+
+                bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &) override
+                {
+                    return false;
+                }
+
+            private:
+                enum class Key
+                {
+                    Other,
+                    Result,
+                    Points,
+                    NextOffset,
+                    Id,
+                    Vector,
+                    Payload,
+                };
+
+                struct Frame
+                {
+                    bool is_array;
+                    Key key;
+                };
+
+                // root object, "result" object, "points" array, point object
+                static constexpr size_t kPointDepth = 4;
+
+                bool InResult() const
+                {
+                    return frames.size() >= 2 && frames[0].key == Key::Result && !frames[1].is_array;
+                }
+
+                bool InPoint() const
+                {
+                    return !in_payload && frames.size() == kPointDepth && !frames.back().is_array && InResult() &&
+                           frames[1].key == Key::Points && frames[2].is_array;
+                }
+
+                bool AtPointKey(Key key) const
+                {
+                    return InPoint() && frames.back().key == key;
+                }
+
+                bool Number(double value, std::string_view text)
+                {
+                    if (in_payload)
+                    {
+                        payload.Scalar(text);
+                    }
+                    else if (in_vector)
+                    {
+                        scratch.push_back(static_cast<float>(value));
+                    }
+                    return true;
+                }
+
+                std::vector<Frame> frames;
+                bool has_id = false;
+                bool in_payload = false;
+                bool in_vector = false;
+                PayloadWriter payload;
+                std::vector<float> scratch; // the vector being read, before it is appended to the page
+            };
+
+            std::vector<std::vector<SearchResult>> ParseSearchResults(const std::string &body, util::arena::RequestArena &arena, bool batched)
+            {
+                SearchResponseHandler handler(arena, batched);
+                if (!json::sax_parse(body, &handler) || !handler.saw_result)
+                {
+                    throw std::runtime_error("Invalid search response format: " +
+                                             (handler.error.empty() ? body : handler.error));
+                }
+                return std::move(handler.results);
+            }
+        }
+
         util::http::HttpResponse VectorRepository::CreateCollection(const std::string &collection_name, int vector_size) const
         {
             const std::string path = "/collections/" + collection_name;
@@ -28,95 +614,183 @@ namespace repositories
             return http_client.Delete(path);
         }
 
-        util::http::HttpResponse VectorRepository::UpsertPoint(const std::string &collection_name, const VectorPoint &point) const
+        std::string VectorRepository::SerializePoints(const std::vector<VectorPoint> &points)
         {
-            const std::string path = "/collections/" + collection_name + "/points";
-
             std::ostringstream json_body;
-            json_body << "{\"points\":[{\"id\":" << point.id << ",\"vector\":[";
+            json_body << "{\"points\":[";
 
-            for (size_t i = 0; i < point.vector.size(); ++i)
+            for (size_t p = 0; p < points.size(); ++p)
             {
-                if (i > 0)
+                if (p > 0)
                     json_body << ",";
-                json_body << point.vector[i];
+                WritePoint(json_body, points[p]);
             }
 
-            json_body << "],\"payload\":" << point.payload << "}]}";
+            json_body << "]}";
+            return json_body.str();
+        }
 
-            return http_client.Put(path, json_body.str());
+        std::string VectorRepository::SerializeSearchRequest(util::embedding::ConstRowView query_vector, int limit)
+        {
+            std::ostringstream json_body;
+            WriteSearchRequest(json_body, query_vector, limit);
+            return json_body.str();
         }
 
-        util::http::HttpResponse VectorRepository::UpsertPoints(const std::string &collection_name, const std::vector<VectorPoint> &points) const
+        std::vector<SearchResult> VectorRepository::ParseSearchResponse(const std::string &body, util::arena::RequestArena &arena)
+        {
+            std::vector<std::vector<SearchResult>> results = ParseSearchResults(body, arena, false);
+            return std::move(results.front());
+        }
+
+        util::http::HttpResponse VectorRepository::UpsertPoint(const std::string &collection_name, const VectorPoint &point) const
         {
             const std::string path = "/collections/" + collection_name + "/points";
 
             std::ostringstream json_body;
             json_body << "{\"points\":[";
-
-            for (size_t p = 0; p < points.size(); ++p)
-            {
-                if (p > 0)
-                    json_body << ",";
-
-                json_body << "{\"id\":" << points[p].id << ",\"vector\":[";
-
-                for (size_t i = 0; i < points[p].vector.size(); ++i)
-                {
-                    if (i > 0)
-                        json_body << ",";
-                    json_body << points[p].vector[i];
-                }
-
-                json_body << "],\"payload\":" << points[p].payload << "}";
-            }
-
+            WritePoint(json_body, point);
             json_body << "]}";
 
             return http_client.Put(path, json_body.str());
         }
 
-        util::http::HttpResponse VectorRepository::DeletePoint(const std::string &collection_name, int point_id) const
+        util::http::HttpResponse VectorRepository::UpsertPoints(const std::string &collection_name, const std::vector<VectorPoint> &points) const
+        {
+            const std::string path = "/collections/" + collection_name + "/points";
+            return http_client.Put(path, SerializePoints(points));
+        }
+
+        util::http::HttpResponse VectorRepository::DeletePoint(const std::string &collection_name, PointId point_id) const
+        {
+            return DeletePoints(collection_name, {point_id});
+        }
+
+        util::http::HttpResponse VectorRepository::DeletePoints(const std::string &collection_name, const std::vector<PointId> &point_ids) const
         {
             const std::string path = "/collections/" + collection_name + "/points/delete";
             std::ostringstream json_body;
-            json_body << "{\"points\":[" << point_id << "]}";
+            json_body << "{\"points\":[";
+            for (size_t i = 0; i < point_ids.size(); ++i)
+            {
+                if (i > 0)
+                    json_body << ",";
+                json_body << point_ids[i];
+            }
+            json_body << "]}";
             return http_client.Post(path, json_body.str());
         }
 
         std::vector<SearchResult> VectorRepository::SearchSimilar(const std::string &collection_name,
-                                                                  const std::vector<float> &query_vector,
-                                                                  int limit) const
+                                                                  util::embedding::ConstRowView query_vector,
+                                                                  util::arena::RequestArena &arena,
+                                                                  int limit,
+                                                                  const util::context::RequestContext &context) const
         {
             const std::string path = "/collections/" + collection_name + "/points/search";
 
-            std::ostringstream json_body;
-            json_body << "{\"vector\":[";
+            util::http::HttpResponse response = http_client.Post(path, SerializeSearchRequest(query_vector, limit), context);
+            if (response.status_code == 0)
+            {
+                context.ThrowIfDone("vector.search");
+            }
+            response.ThrowErrorIfFailed();
 
-            for (size_t i = 0; i < query_vector.size(); ++i)
+            return ParseSearchResponse(response.body, arena);
+        }
+
+        std::vector<std::vector<SearchResult>> VectorRepository::SearchSimilarBatch(const std::string &collection_name,
+                                                                                    const util::embedding::EmbeddingMatrix &query_vectors,
+                                                                                    util::arena::RequestArena &arena,
+                                                                                    int limit,
+                                                                                    const util::context::RequestContext &context) const
+        {
+            if (query_vectors.Empty())
             {
-                if (i > 0)
-                    json_body << ",";
-                json_body << query_vector[i];
+                return {};
             }
 
-            json_body << "],\"limit\":" << limit << ",\"with_payload\":true}";
+            const std::string path = "/collections/" + collection_name + "/points/search/batch";
+
+            std::ostringstream json_body;
+            json_body << "{\"searches\":[";
+            for (size_t q = 0; q < query_vectors.Rows(); ++q)
+            {
+                if (q > 0)
+                    json_body << ",";
+                WriteSearchRequest(json_body, query_vectors.Row(q), limit);
+            }
+            json_body << "]}";
 
-            util::http::HttpResponse response = http_client.Post(path, json_body.str());
+            util::http::HttpResponse response = http_client.Post(path, json_body.str(), context);
+            if (response.status_code == 0)
+            {
+                context.ThrowIfDone("vector.search_batch");
+            }
             response.ThrowErrorIfFailed();
 
-            std::vector<SearchResult> context_documents;
-            json search_json = json::parse(response.body);
-            for (const auto &result : search_json["result"])
+            std::vector<std::vector<SearchResult>> results = ParseSearchResults(response.body, arena, true);
+            if (results.size() != query_vectors.Rows())
+            {
+                throw std::runtime_error("Invalid batch search response format: " + response.body);
+            }
+            return results;
+        }
+
+        std::string VectorRepository::SerializeScrollRequest(const ScrollRequest &request)
+        {
+            json body = {{"limit", request.limit}, {"with_vector", request.with_vector}};
+            if (request.offset)
+            {
+                body["offset"] = *request.offset;
+            }
+            if (request.with_payload && !request.payload_fields.empty())
+            {
+                body["with_payload"] = request.payload_fields;
+            }
+            else
             {
-                const auto &payload = result["payload"];
-                SearchResult point{
-                    result["id"].get<int>(),
-                    result["score"].get<float>(),
-                    payload["text"].get<std::string>()};
-                context_documents.push_back(point);
+                body["with_payload"] = request.with_payload;
             }
-            return context_documents;
+            return body.dump();
+        }
+
+        ScrollPage VectorRepository::ParseScrollResponse(const std::string &body)
+        {
+            ScrollResponseHandler handler;
+            if (!json::sax_parse(body, &handler) || !handler.saw_points)
+            {
+                throw std::runtime_error("Invalid scroll response format: " +
+                                         (handler.error.empty() ? body : handler.error));
+            }
+
+            // Either every point carries a vector (and payload) or none does
+            const size_t size = handler.ids.size();
+            if ((handler.vectors && handler.vectors->Rows() != size) ||
+                (!handler.payloads.empty() && handler.payloads.size() != size))
+            {
+                throw std::runtime_error("Scroll response mixes points with and without vectors or payloads");
+            }
+            return ScrollPage{std::move(handler.ids),
+                              handler.vectors ? std::move(*handler.vectors) : util::embedding::EmbeddingMatrix(),
+                              std::move(handler.payloads),
+                              handler.next_offset};
+        }
+
+        ScrollPage VectorRepository::ScrollPoints(const std::string &collection_name,
+                                                  const ScrollRequest &request,
+                                                  const util::context::RequestContext &context) const
+        {
+            const std::string path = "/collections/" + collection_name + "/points/scroll";
+
+            util::http::HttpResponse response = http_client.Post(path, SerializeScrollRequest(request), context);
+            if (response.status_code == 0)
+            {
+                context.ThrowIfDone("vector.scroll");
+            }
+            response.ThrowErrorIfFailed();
+
+            return ParseScrollResponse(response.body);
         }
     }
 };
\ No newline at end of file
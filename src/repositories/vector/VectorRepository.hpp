@@ -1,26 +1,54 @@
 #pragma once
 
 #include "util/http_client/HttpClient.hpp"
+#include "util/arena/RequestArena.hpp"
+#include "util/embedding/EmbeddingMatrix.hpp"
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace repositories
 {
     namespace vector
     {
+        // Qdrant accepts unsigned 64-bit integer point ids
+        using PointId = std::uint64_t;
+
         struct VectorPoint
         {
-            int id;
-            std::vector<float> vector;
+            PointId id;
+            util::embedding::ConstRowView vector; // not owned; keep the matrix or vector alive until upserted
             std::string payload; // JSON string
         };
 
         class SearchResult
         {
         public:
-            int id;
+            PointId id;
             float score;
-            std::string payload;
+            std::string_view payload; // text held by the RequestArena the search was given
+        };
+
+        struct ScrollRequest
+        {
+            size_t limit = 256;
+            std::optional<PointId> offset; // first id of the page; none for the start of the collection
+            bool with_vector = true;
+            bool with_payload = true;
+            std::vector<std::string> payload_fields; // only these payload keys, when non-empty
+        };
+
+        // One page of points in id order; row i of `vectors` and payloads[i] belong to ids[i]
+        struct ScrollPage
+        {
+            std::vector<PointId> ids;
+            util::embedding::EmbeddingMatrix vectors; // empty without with_vector
+            std::vector<std::string> payloads;        // JSON objects; empty without with_payload
+            std::optional<PointId> next_offset;       // none on the last page
+
+            size_t Size() const { return ids.size(); }
         };
 
         class VectorRepository
@@ -39,12 +67,32 @@ namespace repositories
             // Point operations
             util::http::HttpResponse UpsertPoint(const std::string &collection_name, const VectorPoint &point) const;
             util::http::HttpResponse UpsertPoints(const std::string &collection_name, const std::vector<VectorPoint> &points) const;
-            util::http::HttpResponse DeletePoint(const std::string &collection_name, int point_id) const;
+            util::http::HttpResponse DeletePoint(const std::string &collection_name, PointId point_id) const;
+            util::http::HttpResponse DeletePoints(const std::string &collection_name, const std::vector<PointId> &point_ids) const;
 
             // Search
             std::vector<SearchResult> SearchSimilar(const std::string &collection_name,
-                                                    const std::vector<float> &query_vector,
-                                                    int limit = 10) const;
+                                                    util::embedding::ConstRowView query_vector,
+                                                    util::arena::RequestArena &arena,
+                                                    int limit = 10,
+                                                    const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+            std::vector<std::vector<SearchResult>> SearchSimilarBatch(const std::string &collection_name,
+                                                                      const util::embedding::EmbeddingMatrix &query_vectors,
+                                                                      util::arena::RequestArena &arena,
+                                                                      int limit = 10,
+                                                                      const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            // Reads stored points back in id order, one page per call
+            ScrollPage ScrollPoints(const std::string &collection_name,
+                                    const ScrollRequest &request,
+                                    const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            // Request/response encoding, exposed so it can be benchmarked without a server
+            static std::string SerializePoints(const std::vector<VectorPoint> &points);
+            static std::string SerializeSearchRequest(util::embedding::ConstRowView query_vector, int limit);
+            static std::vector<SearchResult> ParseSearchResponse(const std::string &body, util::arena::RequestArena &arena);
+            static std::string SerializeScrollRequest(const ScrollRequest &request);
+            static ScrollPage ParseScrollResponse(const std::string &body);
         };
     }
 };
\ No newline at end of file
@@ -1,28 +1,107 @@
 #include "EmbedderService.hpp"
 
+#include "util/trace/Tracer.hpp"
+
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <vector>
+
 using json = nlohmann::json;
 
 namespace services
 {
     namespace embedder
     {
-        std::vector<float> EmbedderService::GetEmbedding(const std::string &input) const
+        util::embedding::EmbeddingMatrix EmbedderService::GetEmbedding(const std::string &input,
+                                                                       const util::context::RequestContext &context) const
         {
-            util::http::HttpResponse response = embedder_repository.GetEmbedding(input);
+            util::trace::ScopedSpan span("embedder.embed");
+            context.ThrowIfDone("embedder.embed");
+            util::http::HttpResponse response = embedder_repository.GetEmbedding(input, context);
+            if (response.status_code == 0)
+            {
+                context.ThrowIfDone("embedder.embed");
+            }
             response.ThrowErrorIfFailed();
+            return ParseEmbeddingResponse(response.body);
+        };
 
-            json response_json = json::parse(response.body);
-            if (
-                !response_json.contains("data") || !response_json["data"].is_array() ||
-                response_json["data"].empty() || !response_json["data"][0].contains("embedding") ||
-                !response_json["data"][0]["embedding"].is_array())
+        util::embedding::EmbeddingMatrix EmbedderService::ParseEmbeddingResponse(const std::string &body, size_t expected_rows)
+        {
+            json response_json = json::parse(body);
+            if (!response_json.contains("data") || !response_json["data"].is_array() ||
+                response_json["data"].size() != expected_rows)
             {
-                throw std::runtime_error("Invalid embedding response format: " + response.body);
+                throw std::runtime_error("Invalid embedding response format: " + body);
             }
-            const auto &embedding = response_json["data"][0]["embedding"];
-            return embedding.get<std::vector<float>>();
-        };
+
+            const json &data = response_json["data"];
+            if (data.empty())
+            {
+                return util::embedding::EmbeddingMatrix();
+            }
+            if (!data[0].contains("embedding") || !data[0]["embedding"].is_array())
+            {
+                throw std::runtime_error("Invalid embedding response format: " + body);
+            }
+
+            // Every row is written in place; no per-embedding vectors are allocated
+            util::embedding::EmbeddingMatrix embeddings(data[0]["embedding"].size(), expected_rows);
+            std::vector<bool> filled(embeddings.Rows(), false);
+            for (size_t i = 0; i < data.size(); ++i)
+            {
+                const auto &item = data[i];
+                if (!item.contains("embedding") || !item["embedding"].is_array() ||
+                    item["embedding"].size() != embeddings.Dimension())
+                {
+                    throw std::runtime_error("Invalid embedding response format: " + body);
+                }
+                // The server reports each embedding's input position; fall back to array order.
+                const size_t index = item.contains("index") ? item["index"].get<size_t>() : i;
+                if (index >= embeddings.Rows())
+                {
+                    throw std::runtime_error("Embedding index out of range: " + std::to_string(index));
+                }
+                if (filled[index])
+                {
+                    throw std::runtime_error("Duplicate embedding index: " + std::to_string(index));
+                }
+                filled[index] = true;
+
+                const util::embedding::RowView row = embeddings.Row(index);
+                const json &values = item["embedding"];
+                for (size_t j = 0; j < row.size(); ++j)
+                {
+                    row[j] = values[j].get<float>();
+                }
+            }
+            // A row left zero-filled would silently score 0 against every point
+            const auto missing = std::find(filled.begin(), filled.end(), false);
+            if (missing != filled.end())
+            {
+                throw std::runtime_error("Missing embedding index: " + std::to_string(missing - filled.begin()));
+            }
+            return embeddings;
+        }
+
+        util::embedding::EmbeddingMatrix EmbedderService::GetEmbeddings(const std::vector<std::string> &inputs,
+                                                                        const util::context::RequestContext &context) const
+        {
+            if (inputs.empty())
+            {
+                return util::embedding::EmbeddingMatrix();
+            }
+
+            util::trace::ScopedSpan span("embedder.embed_batch");
+            context.ThrowIfDone("embedder.embed_batch");
+            util::http::HttpResponse response = embedder_repository.GetEmbeddings(inputs, context);
+            if (response.status_code == 0)
+            {
+                context.ThrowIfDone("embedder.embed_batch");
+            }
+            response.ThrowErrorIfFailed();
+            return ParseEmbeddingResponse(response.body, inputs.size());
+        }
     }
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "repositories/embedder/EmbedderRepository.hpp"
+#include "util/embedding/EmbeddingMatrix.hpp"
 
 #include <vector>
 
@@ -16,7 +17,16 @@ namespace services
         public:
             explicit EmbedderService(repositories::embedder::EmbedderRepository repository) : embedder_repository(std::move(repository)) {}
 
-            std::vector<float> GetEmbedding(const std::string &input) const;
+            // One-row matrix
+            util::embedding::EmbeddingMatrix GetEmbedding(const std::string &input,
+                                                          const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            // Embeds all inputs with a single request; row i belongs to inputs[i].
+            util::embedding::EmbeddingMatrix GetEmbeddings(const std::vector<std::string> &inputs,
+                                                           const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            // Decodes straight into one matrix, ordered by each item's "index"
+            static util::embedding::EmbeddingMatrix ParseEmbeddingResponse(const std::string &body, size_t expected_rows = 1);
         };
     }
 };
@@ -1,6 +1,11 @@
 #include "./LlmService.hpp"
+
+#include "util/trace/Tracer.hpp"
+
+#include <algorithm>
 #include <cctype>
-#include <sstream>
+#include <charconv>
+#include <chrono>
 
 namespace services
 {
@@ -40,20 +45,21 @@ namespace services
 
                 return trimmed.substr(0, last_end + 1);
             }
+
+            // Rough English average; the completion endpoint does not report a count
+            constexpr double kCharactersPerToken = 4.0;
+            // Weight of the newest sample in the per-token cost average
+            constexpr double kCostSmoothing = 0.2;
+            // Share of the remaining budget generation may use; the rest covers the round trip
+            constexpr double kGenerationShare = 0.8;
         }
 
-        std::string LlmService::GenerateAnswer(const std::string &question,
-                                               const std::vector<std::string> &context_documents,
-                                               unsigned int max_tokens) const
+        std::pmr::vector<std::string_view> LlmService::BuildPrompt(const std::string &question,
+                                                                   const std::vector<std::string_view> &context_documents,
+                                                                   unsigned int max_tokens,
+                                                                   util::arena::RequestArena &arena)
         {
-            // Build context from documents
-            std::ostringstream context_builder;
-            context_builder << "Context information:\\n";
-            for (size_t i = 0; i < context_documents.size(); ++i)
-            {
-                context_builder << "[" << (i + 1) << "] " << context_documents[i] << "\\n";
-            }
-            context_builder << "\\n";
+            util::trace::ScopedSpan span("llm.build_prompt");
 
             unsigned int max_words = static_cast<unsigned int>(max_tokens * 0.75);
             if (max_words < 20)
@@ -61,16 +67,65 @@ namespace services
                 max_words = 20;
             }
 
-            // Build the prompt
-            std::ostringstream prompt_builder;
-            prompt_builder << "You are a helpful assistant. Answer the following question based on the provided context information. "
-                           << "Keep the answer under about " << max_words << " words and finish your last sentence.\\n\\n"
-                           << context_builder.str()
-                           << "Question: " << question << "\\n"
-                           << "Answer: ";
+            // Only the numbers are materialized; everything else is a view of a
+            // literal, the question or a context document.
+            const auto format_number = [&arena](size_t value)
+            {
+                char *digits = static_cast<char *>(arena.allocate(20, alignof(char)));
+                const char *end = std::to_chars(digits, digits + 20, value).ptr;
+                return std::string_view(digits, static_cast<size_t>(end - digits));
+            };
+
+            std::pmr::vector<std::string_view> fragments(&arena);
+            fragments.reserve(10 + 4 * context_documents.size());
+            fragments.insert(fragments.end(), {"You are a helpful assistant. Answer the following question based on the provided context information. ",
+                                               "Keep the answer under about ", format_number(max_words),
+                                               " words and finish your last sentence.\\n\\n",
+                                               "Context information:\\n"});
+            for (size_t i = 0; i < context_documents.size(); ++i)
+            {
+                fragments.insert(fragments.end(), {"[", format_number(i + 1), "] ", context_documents[i], "\\n"});
+            }
+            fragments.insert(fragments.end(), {"\\n", "Question: ", question, "\\n", "Answer: "});
+            return fragments;
+        }
+
+        std::string LlmService::GenerateAnswer(const std::string &question,
+                                               const std::vector<std::string_view> &context_documents,
+                                               util::arena::RequestArena &arena,
+                                               unsigned int max_tokens,
+                                               const util::context::RequestContext &context) const
+        {
+            util::trace::ScopedSpan span("llm.generate");
+            context.ThrowIfDone("llm.generate");
+            max_tokens = AdaptMaxTokens(max_tokens, context);
+
+            const auto start = std::chrono::steady_clock::now();
+            std::string response = llm_repository.GenerateCompletion(BuildPrompt(question, context_documents, max_tokens, arena), arena, max_tokens, context);
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-            std::string response = llm_repository.GenerateCompletion(prompt_builder.str(), max_tokens);
+            const double tokens = std::max(1.0, static_cast<double>(response.size()) / kCharactersPerToken);
+            const double sample = elapsed / tokens;
+            const double previous = seconds_per_token.load(std::memory_order_relaxed);
+            seconds_per_token.store(previous == 0.0 ? sample : previous + kCostSmoothing * (sample - previous),
+                                    std::memory_order_relaxed);
             return TrimToLastSentence(response);
         }
+
+        unsigned int LlmService::AdaptMaxTokens(unsigned int max_tokens, const util::context::RequestContext &context) const
+        {
+            const double cost = seconds_per_token.load(std::memory_order_relaxed);
+            if (!context.HasDeadline() || cost <= 0.0 || max_tokens <= kMinAnswerTokens)
+            {
+                return max_tokens;
+            }
+            const double remaining = std::chrono::duration<double>(context.Remaining()).count();
+            const double affordable = remaining * kGenerationShare / cost;
+            if (affordable >= max_tokens)
+            {
+                return max_tokens;
+            }
+            return std::max(kMinAnswerTokens, static_cast<unsigned int>(affordable));
+        }
     }
 };
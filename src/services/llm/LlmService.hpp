@@ -1,7 +1,10 @@
 #pragma once
 
 #include "repositories/llm/LlmRepository.hpp"
+#include <atomic>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace services
@@ -12,13 +15,29 @@ namespace services
         {
         private:
             repositories::llm::LlmRepository llm_repository;
+            // Smoothed generation time per answer token, learned from completed calls; 0 until the first one
+            mutable std::atomic<double> seconds_per_token{0.0};
 
         public:
+            // Fewest tokens worth asking for when the budget is nearly spent
+            static constexpr unsigned int kMinAnswerTokens = 16;
+
             explicit LlmService(repositories::llm::LlmRepository repository) : llm_repository(std::move(repository)) {}
 
             std::string GenerateAnswer(const std::string &question,
-                                       const std::vector<std::string> &context_documents,
-                                       unsigned int max_tokens = 128) const;
+                                       const std::vector<std::string_view> &context_documents,
+                                       util::arena::RequestArena &arena,
+                                       unsigned int max_tokens = 128,
+                                       const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            // max_tokens, lowered to what the remaining budget is expected to afford
+            unsigned int AdaptMaxTokens(unsigned int max_tokens, const util::context::RequestContext &context) const;
+
+            // Prompt as a list of views, allocated in the arena and never concatenated
+            static std::pmr::vector<std::string_view> BuildPrompt(const std::string &question,
+                                                                  const std::vector<std::string_view> &context_documents,
+                                                                  unsigned int max_tokens,
+                                                                  util::arena::RequestArena &arena);
         };
     }
 };
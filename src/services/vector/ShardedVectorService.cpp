@@ -0,0 +1,276 @@
+#include "ShardedVectorService.hpp"
+
+#include "util/trace/Tracer.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace services
+{
+    namespace vector
+    {
+        namespace
+        {
+            // Shared by one search call and its shard tasks; whichever finishes last frees it
+            struct FanOut
+            {
+                std::mutex mutex;
+                std::condition_variable done;
+                size_t pending;
+                std::vector<float> query;
+                util::arena::RequestArena arena; // payloads of every shard's results
+                std::vector<std::optional<std::vector<repositories::vector::SearchResult>>> results;
+                std::vector<bool> failed;
+
+                explicit FanOut(size_t shard_count) : pending(shard_count), results(shard_count), failed(shard_count, false) {}
+            };
+
+            void NormalizeMinMax(std::vector<repositories::vector::SearchResult> &ranking)
+            {
+                if (ranking.empty())
+                {
+                    return;
+                }
+                const auto [lowest, highest] = std::minmax_element(ranking.begin(), ranking.end(), [](const auto &lhs, const auto &rhs)
+                                                                   { return lhs.score < rhs.score; });
+                const float minimum = lowest->score;
+                const float range = highest->score - minimum;
+                for (auto &result : ranking)
+                {
+                    result.score = range > 0.0f ? (result.score - minimum) / range : 1.0f;
+                }
+            }
+        }
+
+        std::vector<Shard> ParseShards(const std::string &spec, const std::string &default_collection)
+        {
+            std::vector<Shard> shards;
+            std::istringstream entries(spec);
+            std::string entry;
+            while (std::getline(entries, entry, ','))
+            {
+                entry.erase(0, entry.find_first_not_of(" \t"));
+                entry.erase(entry.find_last_not_of(" \t") + 1);
+                if (entry.empty())
+                {
+                    continue;
+                }
+
+                // "@" only separates a collection when it comes before the scheme
+                const size_t at = entry.find('@');
+                const size_t scheme = entry.find("://");
+                std::string collection = default_collection;
+                std::string url = entry;
+                if (at != std::string::npos && (scheme == std::string::npos || at < scheme))
+                {
+                    collection = entry.substr(0, at);
+                    url = entry.substr(at + 1);
+                }
+                if (collection.empty() || url.empty())
+                {
+                    throw std::runtime_error("Invalid shard entry: " + entry);
+                }
+
+                shards.push_back(Shard{collection + "@" + url,
+                                       repositories::vector::VectorRepository(util::http::HttpClient(url)),
+                                       collection});
+            }
+            return shards;
+        }
+
+        ScoreNormalization ParseScoreNormalization(const std::string &name)
+        {
+            if (name == "raw")
+                return ScoreNormalization::Raw;
+            if (name == "minmax")
+                return ScoreNormalization::MinMax;
+            throw std::runtime_error("Unknown score normalization: " + name);
+        }
+
+        ScoreNormalization DefaultScoreNormalization(const std::vector<Shard> &shards)
+        {
+            const bool one_collection = std::all_of(shards.begin(), shards.end(), [&shards](const Shard &shard)
+                                                    { return shard.collection_name == shards.front().collection_name; });
+            return one_collection ? ScoreNormalization::Raw : ScoreNormalization::MinMax;
+        }
+
+        bool ShardedVectorService::ServesOnly(const std::string &collection_name) const
+        {
+            return std::all_of(shards.begin(), shards.end(), [&collection_name](const Shard &shard)
+                               { return shard.collection_name == collection_name; });
+        }
+
+        ShardedVectorService::ShardedVectorService(std::vector<Shard> shards, ShardedSearchOptions options, size_t thread_count)
+            : shards(std::move(shards)),
+              options(options),
+              pool(thread_count > 0 ? thread_count : std::max<size_t>(2, 2 * this->shards.size()))
+        {
+            if (this->shards.empty())
+            {
+                throw std::runtime_error("Sharded search needs at least one shard");
+            }
+        }
+
+        ShardedSearchResult ShardedVectorService::SearchSimilar(util::embedding::ConstRowView query_vector,
+                                                                util::arena::RequestArena &arena,
+                                                                int limit,
+                                                                const util::context::RequestContext &context) const
+        {
+            util::trace::ScopedSpan span("vector.sharded_search");
+            context.ThrowIfDone("vector.sharded_search");
+            // Shards get their own context so they can be cut off without cancelling the request
+            const auto shard_context = util::context::RequestContext::WithTimeout(
+                std::min(options.deadline, context.Remaining()));
+            const auto deadline = shard_context.Deadline();
+
+            auto fan_out = std::make_shared<FanOut>(shards.size());
+            fan_out->query.assign(query_vector.begin(), query_vector.end());
+
+            for (size_t i = 0; i < shards.size(); ++i)
+            {
+                pool.Submit([this, fan_out, i, limit, shard_context]()
+                            {
+                    util::trace::ScopedSpan shard_span("vector.shard_search", shards[i].name);
+                    std::optional<std::vector<repositories::vector::SearchResult>> results;
+                    try
+                    {
+                        results = shards[i].repository.SearchSimilar(shards[i].collection_name, fan_out->query, fan_out->arena, limit, shard_context);
+                    }
+                    catch (const std::exception &)
+                    {
+                    }
+
+                    std::lock_guard<std::mutex> lock(fan_out->mutex);
+                    fan_out->results[i] = std::move(results);
+                    fan_out->failed[i] = !fan_out->results[i].has_value();
+                    --fan_out->pending;
+                    fan_out->done.notify_all(); });
+            }
+
+            ShardedSearchResult merged;
+            std::vector<std::vector<repositories::vector::SearchResult>> rankings;
+            std::vector<std::string> ranking_collections;
+            {
+                std::unique_lock<std::mutex> lock(fan_out->mutex);
+                fan_out->done.wait_until(lock, deadline, [&fan_out]()
+                                         { return fan_out->pending == 0; });
+
+                for (size_t i = 0; i < shards.size(); ++i)
+                {
+                    if (fan_out->results[i])
+                    {
+                        ++merged.answered;
+                        rankings.push_back(*fan_out->results[i]);
+                        ranking_collections.push_back(shards[i].collection_name);
+                    }
+                    else if (fan_out->failed[i])
+                    {
+                        merged.failed.push_back(shards[i].name);
+                    }
+                    else
+                    {
+                        merged.timed_out.push_back(shards[i].name);
+                    }
+                }
+            }
+            shard_context.Cancel();
+
+            std::vector<size_t> sources;
+            merged.results = MergeShardResults(std::move(rankings), ranking_collections, limit, options.normalization, &sources);
+            merged.collections.reserve(sources.size());
+            for (const size_t source : sources)
+            {
+                merged.collections.push_back(ranking_collections[source]);
+            }
+            // The fan-out arena may outlive this call by a late shard, or die right after it
+            for (auto &result : merged.results)
+            {
+                result.payload = arena.Copy(result.payload);
+            }
+            return merged;
+        }
+
+        std::vector<repositories::vector::SearchResult> ShardedVectorService::MergeShardResults(
+            std::vector<std::vector<repositories::vector::SearchResult>> rankings,
+            const std::vector<std::string> &collections,
+            int limit,
+            ScoreNormalization normalization,
+            std::vector<size_t> *sources)
+        {
+            if (collections.size() != rankings.size())
+            {
+                throw std::runtime_error("Every shard ranking needs its collection name");
+            }
+
+            // Rankings over the same collection share an id space; number each distinct collection once
+            std::vector<size_t> id_space(rankings.size());
+            for (size_t r = 0; r < rankings.size(); ++r)
+            {
+                id_space[r] = static_cast<size_t>(std::find(collections.begin(), collections.end(), collections[r]) - collections.begin());
+            }
+            if (sources != nullptr)
+            {
+                sources->clear();
+            }
+
+            for (auto &ranking : rankings)
+            {
+                std::stable_sort(ranking.begin(), ranking.end(), [](const auto &lhs, const auto &rhs)
+                                 { return lhs.score > rhs.score; });
+                if (normalization == ScoreNormalization::MinMax)
+                {
+                    NormalizeMinMax(ranking);
+                }
+            }
+
+            // Head of every ranking; ties go to the earlier shard
+            struct Cursor
+            {
+                float score;
+                size_t ranking;
+                size_t position;
+            };
+            const auto lower = [](const Cursor &lhs, const Cursor &rhs)
+            {
+                return lhs.score != rhs.score ? lhs.score < rhs.score : lhs.ranking > rhs.ranking;
+            };
+            std::priority_queue<Cursor, std::vector<Cursor>, decltype(lower)> heads(lower);
+            for (size_t r = 0; r < rankings.size(); ++r)
+            {
+                if (!rankings[r].empty())
+                {
+                    heads.push(Cursor{rankings[r][0].score, r, 0});
+                }
+            }
+
+            std::vector<repositories::vector::SearchResult> merged;
+            std::set<std::pair<size_t, repositories::vector::PointId>> seen;
+            while (!heads.empty() && (limit < 0 || merged.size() < static_cast<size_t>(limit)))
+            {
+                const Cursor head = heads.top();
+                heads.pop();
+
+                const repositories::vector::SearchResult &result = rankings[head.ranking][head.position];
+                if (seen.emplace(id_space[head.ranking], result.id).second)
+                {
+                    merged.push_back(result);
+                    if (sources != nullptr)
+                    {
+                        sources->push_back(head.ranking);
+                    }
+                }
+                if (head.position + 1 < rankings[head.ranking].size())
+                {
+                    heads.push(Cursor{rankings[head.ranking][head.position + 1].score, head.ranking, head.position + 1});
+                }
+            }
+            return merged;
+        }
+    }
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "repositories/vector/VectorRepository.hpp"
+#include "util/concurrency/ThreadPool.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace services
+{
+    namespace vector
+    {
+        struct Shard
+        {
+            std::string name; // for logs and traces
+            repositories::vector::VectorRepository repository;
+            std::string collection_name;
+        };
+
+        // Parses "collection@url,collection@url,..."; an entry without "collection@"
+        // uses default_collection.
+        std::vector<Shard> ParseShards(const std::string &spec, const std::string &default_collection);
+
+        enum class ScoreNormalization
+        {
+            Raw,    // scores are already comparable, e.g. one collection partitioned across nodes
+            MinMax, // each shard's scores rescaled to [0, 1] before merging
+        };
+
+        // "raw" or "minmax"
+        ScoreNormalization ParseScoreNormalization(const std::string &name);
+
+        // Raw when every shard searches the same collection, MinMax when they mix collections
+        ScoreNormalization DefaultScoreNormalization(const std::vector<Shard> &shards);
+
+        struct ShardedSearchOptions
+        {
+            std::chrono::milliseconds deadline{250}; // shards that have not answered by then are left out
+            ScoreNormalization normalization = ScoreNormalization::MinMax;
+        };
+
+        struct ShardedSearchResult
+        {
+            std::vector<repositories::vector::SearchResult> results;
+            std::vector<std::string> collections; // collections[i] is where results[i] is stored
+            size_t answered = 0;
+            std::vector<std::string> failed;    // shard names that threw
+            std::vector<std::string> timed_out; // shard names still running at the deadline
+
+            bool Partial() const { return !failed.empty() || !timed_out.empty(); }
+        };
+
+        // Dense search over several repositories and/or collections at once. Every
+        // shard is queried concurrently and the per-shard top-k lists are merged;
+        // a shard that fails or misses the deadline only drops its own results.
+        class ShardedVectorService
+        {
+        private:
+            std::vector<Shard> shards;
+            ShardedSearchOptions options;
+            // Declared last so it drains late shard searches before the shards go away
+            mutable util::concurrency::ThreadPool pool;
+
+        public:
+            // A slow shard keeps its worker busy past the deadline, so the pool
+            // defaults to twice the shard count
+            explicit ShardedVectorService(std::vector<Shard> shards, ShardedSearchOptions options = {}, size_t thread_count = 0);
+
+            size_t ShardCount() const { return shards.size(); }
+            // True when every shard searches `collection_name`, so result ids share one id space
+            bool ServesOnly(const std::string &collection_name) const;
+
+            // Result payloads are copied into `arena`; late shards never touch it.
+            // The request's deadline caps options.deadline, and shards still running
+            // when the wait ends are cancelled.
+            ShardedSearchResult SearchSimilar(util::embedding::ConstRowView query_vector,
+                                              util::arena::RequestArena &arena,
+                                              int limit = 10,
+                                              const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            // Heap-based k-way merge of per-shard rankings. Point ids are only unique
+            // within a collection, so a point is identified by its ranking's entry in
+            // `collections` plus its id; one reported by several shards of the same
+            // collection is kept once, at its best position. If `sources` is given,
+            // sources[i] is the ranking merged result i came from.
+            static std::vector<repositories::vector::SearchResult> MergeShardResults(
+                std::vector<std::vector<repositories::vector::SearchResult>> rankings,
+                const std::vector<std::string> &collections,
+                int limit,
+                ScoreNormalization normalization,
+                std::vector<size_t> *sources = nullptr);
+        };
+    }
+};
@@ -1,9 +1,29 @@
 #include "VectorService.hpp"
 
+#include "util/trace/Tracer.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <unordered_map>
+
+using json = nlohmann::json;
+
 namespace services
 {
     namespace vector
     {
+        void VectorService::IndexPayload(const std::string &collection_name, const repositories::vector::VectorPoint &point)
+        {
+            const json payload = json::parse(point.payload, nullptr, false);
+            if (payload.is_object() && payload.contains("text") && payload["text"].is_string())
+            {
+                lexical_repository.AddDocument(collection_name, point.id, payload["text"].get<std::string>());
+            }
+        }
+
         util::http::HttpResponse VectorService::CreateCollection(const std::string &collection_name, int vector_size) const
         {
             return vector_repository.CreateCollection(collection_name, vector_size);
@@ -14,31 +34,163 @@ namespace services
             return vector_repository.GetCollection(collection_name);
         }
 
-        util::http::HttpResponse VectorService::DeleteCollection(const std::string &collection_name) const
+        util::http::HttpResponse VectorService::DeleteCollection(const std::string &collection_name)
         {
+            lexical_repository.DropCollection(collection_name);
             return vector_repository.DeleteCollection(collection_name);
         }
 
-        util::http::HttpResponse VectorService::UpsertPoint(const std::string &collection_name, const repositories::vector::VectorPoint &point) const
+        util::http::HttpResponse VectorService::UpsertPoint(const std::string &collection_name, const repositories::vector::VectorPoint &point)
         {
-            return vector_repository.UpsertPoint(collection_name, point);
+            util::http::HttpResponse response = vector_repository.UpsertPoint(collection_name, point);
+            if (response.status_code >= 200 && response.status_code < 300)
+            {
+                IndexPayload(collection_name, point);
+            }
+            return response;
         }
 
-        util::http::HttpResponse VectorService::UpsertPoints(const std::string &collection_name, const std::vector<repositories::vector::VectorPoint> &points) const
+        util::http::HttpResponse VectorService::UpsertPoints(const std::string &collection_name, const std::vector<repositories::vector::VectorPoint> &points)
         {
-            return vector_repository.UpsertPoints(collection_name, points);
+            util::trace::ScopedSpan span("vector.upsert");
+            util::http::HttpResponse response = vector_repository.UpsertPoints(collection_name, points);
+            if (response.status_code >= 200 && response.status_code < 300)
+            {
+                for (const auto &point : points)
+                {
+                    IndexPayload(collection_name, point);
+                }
+            }
+            return response;
         }
 
-        util::http::HttpResponse VectorService::DeletePoint(const std::string &collection_name, int point_id) const
+        util::http::HttpResponse VectorService::DeletePoint(const std::string &collection_name, repositories::vector::PointId point_id)
         {
+            lexical_repository.RemoveDocument(collection_name, point_id);
             return vector_repository.DeletePoint(collection_name, point_id);
         }
 
+        util::http::HttpResponse VectorService::DeletePoints(const std::string &collection_name, const std::vector<repositories::vector::PointId> &point_ids)
+        {
+            util::trace::ScopedSpan span("vector.delete");
+            for (const auto point_id : point_ids)
+            {
+                lexical_repository.RemoveDocument(collection_name, point_id);
+            }
+            return vector_repository.DeletePoints(collection_name, point_ids);
+        }
+
+        void VectorService::IndexDocument(const std::string &collection_name, repositories::vector::PointId point_id, const std::string &text)
+        {
+            lexical_repository.AddDocument(collection_name, point_id, text);
+        }
+
         std::vector<repositories::vector::SearchResult> VectorService::SearchSimilar(const std::string &collection_name,
-                                                                                     const std::vector<float> &query_vector,
+                                                                                     util::embedding::ConstRowView query_vector,
+                                                                                     util::arena::RequestArena &arena,
+                                                                                     int limit,
+                                                                                     const util::context::RequestContext &context) const
+        {
+            util::trace::ScopedSpan span("vector.search");
+            context.ThrowIfDone("vector.search");
+            return vector_repository.SearchSimilar(collection_name, query_vector, arena, AdaptLimit(limit, context), context);
+        }
+
+        std::vector<std::vector<repositories::vector::SearchResult>> VectorService::SearchSimilarBatch(const std::string &collection_name,
+                                                                                                       const util::embedding::EmbeddingMatrix &query_vectors,
+                                                                                                       util::arena::RequestArena &arena,
+                                                                                                       int limit,
+                                                                                                       const util::context::RequestContext &context) const
+        {
+            util::trace::ScopedSpan span("vector.search_batch");
+            context.ThrowIfDone("vector.search_batch");
+            return vector_repository.SearchSimilarBatch(collection_name, query_vectors, arena, AdaptLimit(limit, context), context);
+        }
+
+        repositories::vector::ScrollPage VectorService::ScrollPoints(const std::string &collection_name,
+                                                                     const repositories::vector::ScrollRequest &request,
+                                                                     const util::context::RequestContext &context) const
+        {
+            util::trace::ScopedSpan span("vector.scroll");
+            context.ThrowIfDone("vector.scroll");
+            return vector_repository.ScrollPoints(collection_name, request, context);
+        }
+
+        std::vector<repositories::vector::SearchResult> VectorService::SearchLexical(const std::string &collection_name,
+                                                                                     const std::string &query_text,
+                                                                                     util::arena::RequestArena &arena,
                                                                                      int limit) const
         {
-            return vector_repository.SearchSimilar(collection_name, query_vector, limit);
+            util::trace::ScopedSpan span("vector.search_lexical");
+            return lexical_repository.Search(collection_name, query_text, arena, limit);
+        }
+
+        std::vector<repositories::vector::SearchResult> VectorService::HybridSearch(const std::string &collection_name,
+                                                                                    const std::string &query_text,
+                                                                                    util::embedding::ConstRowView query_vector,
+                                                                                    util::arena::RequestArena &arena,
+                                                                                    int limit,
+                                                                                    const util::context::RequestContext &context) const
+        {
+            util::trace::ScopedSpan span("vector.hybrid_search");
+            context.ThrowIfDone("vector.hybrid_search");
+            // SearchSimilar adapts the dense side's limit itself
+            const int adapted_limit = AdaptLimit(limit, context);
+
+            // The lexical side finishes long before the HTTP round trip of the dense side
+            std::future<std::vector<repositories::vector::SearchResult>> lexical = std::async(
+                std::launch::async,
+                [this, &collection_name, &query_text, &arena, adapted_limit, trace_context = util::trace::CurrentContext()]()
+                {
+                    util::trace::ScopedContext scope(trace_context);
+                    return SearchLexical(collection_name, query_text, arena, adapted_limit);
+                });
+
+            std::vector<repositories::vector::SearchResult> dense = SearchSimilar(collection_name, query_vector, arena, limit, context);
+            return FuseRankings({dense, lexical.get()}, adapted_limit);
+        }
+
+        int VectorService::AdaptLimit(int limit, const util::context::RequestContext &context)
+        {
+            const double remaining = context.RemainingFraction();
+            if (limit <= 1 || remaining >= 0.5)
+            {
+                return limit;
+            }
+            // Full top-k at half the budget, down to a single document as it runs out
+            return std::max(1, static_cast<int>(std::ceil(limit * remaining * 2.0)));
+        }
+
+        std::vector<repositories::vector::SearchResult> VectorService::FuseRankings(
+            const std::vector<std::vector<repositories::vector::SearchResult>> &rankings,
+            int limit,
+            int k)
+        {
+            std::vector<repositories::vector::SearchResult> fused;
+            std::unordered_map<repositories::vector::PointId, size_t> position_by_id;
+            for (const auto &ranking : rankings)
+            {
+                for (size_t rank = 0; rank < ranking.size(); ++rank)
+                {
+                    const float contribution = 1.0f / static_cast<float>(k + rank + 1);
+                    const auto it = position_by_id.find(ranking[rank].id);
+                    if (it != position_by_id.end())
+                    {
+                        fused[it->second].score += contribution;
+                        continue;
+                    }
+                    position_by_id.emplace(ranking[rank].id, fused.size());
+                    fused.push_back(repositories::vector::SearchResult{ranking[rank].id, contribution, ranking[rank].payload});
+                }
+            }
+
+            std::stable_sort(fused.begin(), fused.end(), [](const auto &lhs, const auto &rhs)
+                             { return lhs.score > rhs.score; });
+            if (limit >= 0 && fused.size() > static_cast<size_t>(limit))
+            {
+                fused.resize(limit);
+            }
+            return fused;
         }
     }
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "repositories/vector/VectorRepository.hpp"
+#include "repositories/lexical/LexicalRepository.hpp"
 
 namespace services
 {
@@ -10,21 +11,69 @@ namespace services
         {
         private:
             repositories::vector::VectorRepository vector_repository;
+            repositories::lexical::LexicalRepository lexical_repository;
+
+            void IndexPayload(const std::string &collection_name, const repositories::vector::VectorPoint &point);
 
         public:
             explicit VectorService(repositories::vector::VectorRepository repository) : vector_repository(std::move(repository)) {}
 
             util::http::HttpResponse CreateCollection(const std::string &collection_name, int vector_size) const;
             util::http::HttpResponse GetCollection(const std::string &collection_name) const;
-            util::http::HttpResponse DeleteCollection(const std::string &collection_name) const;
+            util::http::HttpResponse DeleteCollection(const std::string &collection_name);
+
+            // Successful upserts also index the payload "text" for keyword search
+            util::http::HttpResponse UpsertPoint(const std::string &collection_name, const repositories::vector::VectorPoint &point);
+            util::http::HttpResponse UpsertPoints(const std::string &collection_name, const std::vector<repositories::vector::VectorPoint> &points);
+            util::http::HttpResponse DeletePoint(const std::string &collection_name, repositories::vector::PointId point_id);
+            util::http::HttpResponse DeletePoints(const std::string &collection_name, const std::vector<repositories::vector::PointId> &point_ids);
 
-            util::http::HttpResponse UpsertPoint(const std::string &collection_name, const repositories::vector::VectorPoint &point) const;
-            util::http::HttpResponse UpsertPoints(const std::string &collection_name, const std::vector<repositories::vector::VectorPoint> &points) const;
-            util::http::HttpResponse DeletePoint(const std::string &collection_name, int point_id) const;
+            // Indexes text for keyword search without touching the vector database, for
+            // points that are already stored remotely but missing from the in-process index
+            void IndexDocument(const std::string &collection_name, repositories::vector::PointId point_id, const std::string &text);
 
+            // With less than half of the request's budget left, `limit` shrinks in
+            // proportion so that fewer documents reach the prompt.
             std::vector<repositories::vector::SearchResult> SearchSimilar(const std::string &collection_name,
-                                                                          const std::vector<float> &query_vector,
+                                                                          util::embedding::ConstRowView query_vector,
+                                                                          util::arena::RequestArena &arena,
+                                                                          int limit = 10,
+                                                                          const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+            std::vector<std::vector<repositories::vector::SearchResult>> SearchSimilarBatch(const std::string &collection_name,
+                                                                                            const util::embedding::EmbeddingMatrix &query_vectors,
+                                                                                            util::arena::RequestArena &arena,
+                                                                                            int limit = 10,
+                                                                                            const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            // One page of stored points; see indexing::CollectionScroller for whole collections
+            repositories::vector::ScrollPage ScrollPoints(const std::string &collection_name,
+                                                          const repositories::vector::ScrollRequest &request,
+                                                          const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            // BM25 over the in-process index; never calls the vector database
+            std::vector<repositories::vector::SearchResult> SearchLexical(const std::string &collection_name,
+                                                                          const std::string &query_text,
+                                                                          util::arena::RequestArena &arena,
                                                                           int limit = 10) const;
+
+            // Runs lexical and dense retrieval concurrently and fuses both rankings
+            std::vector<repositories::vector::SearchResult> HybridSearch(const std::string &collection_name,
+                                                                         const std::string &query_text,
+                                                                         util::embedding::ConstRowView query_vector,
+                                                                         util::arena::RequestArena &arena,
+                                                                         int limit = 10,
+                                                                         const util::context::RequestContext &context = util::context::RequestContext::Background()) const;
+
+            // The top-k to ask for given how much of the request's budget is left
+            static int AdaptLimit(int limit, const util::context::RequestContext &context);
+
+            // Search results view payload text held by `arena`; keep it alive while they are used.
+
+            // Reciprocal rank fusion: score(d) = sum over rankings of 1 / (k + rank(d))
+            static std::vector<repositories::vector::SearchResult> FuseRankings(
+                const std::vector<std::vector<repositories::vector::SearchResult>> &rankings,
+                int limit,
+                int k = 60);
         };
     }
-};
\ No newline at end of file
+};
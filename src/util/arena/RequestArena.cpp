@@ -0,0 +1,32 @@
+#include "RequestArena.hpp"
+
+#include <cstring>
+
+namespace util
+{
+    namespace arena
+    {
+        std::string_view RequestArena::Copy(std::string_view text)
+        {
+            if (text.empty())
+            {
+                return {};
+            }
+            char *copy = static_cast<char *>(allocate(text.size(), alignof(char)));
+            std::memcpy(copy, text.data(), text.size());
+            return std::string_view(copy, text.size());
+        }
+
+        void RequestArena::Release()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            monotonic.release();
+        }
+
+        void *RequestArena::do_allocate(size_t bytes, size_t alignment)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return monotonic.allocate(bytes, alignment);
+        }
+    };
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <string_view>
+
+namespace util
+{
+    namespace arena
+    {
+        // Per-request bump allocator. The first kInlineBytes come from storage inside
+        // the arena itself, so a typical query never touches the global heap; all
+        // memory is returned at once when the arena is destroyed or released.
+        // Views handed out by services (search payloads, prompt fragments) live
+        // exactly as long as the arena they were allocated from.
+        class RequestArena : public std::pmr::memory_resource
+        {
+        public:
+            static constexpr size_t kInlineBytes = 16 * 1024;
+
+            RequestArena() : monotonic(inline_buffer, sizeof(inline_buffer), std::pmr::new_delete_resource()) {}
+
+            RequestArena(const RequestArena &) = delete;
+            RequestArena &operator=(const RequestArena &) = delete;
+
+            // Copies text into the arena and returns a view of the copy
+            std::string_view Copy(std::string_view text);
+
+            // Frees everything allocated so far; outstanding views become dangling
+            void Release();
+
+        private:
+            void *do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void *, size_t, size_t) override {}
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+            alignas(std::max_align_t) std::byte inline_buffer[kInlineBytes];
+            std::pmr::monotonic_buffer_resource monotonic;
+            // A request may fan out (e.g. lexical and dense search run concurrently);
+            // the lock is per request, so it is never contended across requests.
+            std::mutex mutex;
+        };
+    };
+};
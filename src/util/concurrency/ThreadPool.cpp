@@ -0,0 +1,137 @@
+#include "ThreadPool.hpp"
+
+namespace util
+{
+    namespace concurrency
+    {
+        namespace
+        {
+            thread_local const ThreadPool *current_pool = nullptr;
+            thread_local size_t current_worker = 0;
+        }
+
+        ThreadPool::ThreadPool(size_t thread_count)
+        {
+            if (thread_count == 0)
+            {
+                thread_count = 1;
+            }
+
+            queues.reserve(thread_count);
+            for (size_t i = 0; i < thread_count; ++i)
+            {
+                queues.push_back(std::make_unique<WorkQueue>());
+            }
+
+            workers.reserve(thread_count);
+            for (size_t i = 0; i < thread_count; ++i)
+            {
+                workers.emplace_back([this, i]()
+                                     { WorkerLoop(i); });
+            }
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                stopping = true;
+            }
+            work_available.notify_all();
+            for (auto &worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        void ThreadPool::WaitIdle()
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            all_idle.wait(lock, [this]()
+                          { return unfinished.load() == 0; });
+        }
+
+        void ThreadPool::Enqueue(std::function<void()> task)
+        {
+            // Tasks spawned by a worker go to its own deque; external submissions
+            // are spread round-robin and balanced out by stealing.
+            const size_t index = current_pool == this
+                                     ? current_worker
+                                     : next_queue.fetch_add(1) % queues.size();
+
+            // Counted before it is published, so a thief that takes it at once never
+            // decrements below zero; an idle worker that sees the count early just retries.
+            unfinished.fetch_add(1);
+            {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                queued.fetch_add(1);
+            }
+            {
+                std::lock_guard<std::mutex> lock(queues[index]->mutex);
+                queues[index]->tasks.push_back(std::move(task));
+            }
+            work_available.notify_one();
+        }
+
+        bool ThreadPool::TryPop(size_t index, std::function<void()> &task)
+        {
+            WorkQueue &queue = *queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+            {
+                return false;
+            }
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+
+        bool ThreadPool::TrySteal(size_t thief, std::function<void()> &task)
+        {
+            for (size_t offset = 1; offset < queues.size(); ++offset)
+            {
+                WorkQueue &victim = *queues[(thief + offset) % queues.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (victim.tasks.empty())
+                {
+                    continue;
+                }
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued.fetch_sub(1);
+                return true;
+            }
+            return false;
+        }
+
+        void ThreadPool::WorkerLoop(size_t index)
+        {
+            current_pool = this;
+            current_worker = index;
+
+            while (true)
+            {
+                std::function<void()> task;
+                if (TryPop(index, task) || TrySteal(index, task))
+                {
+                    task();
+                    if (unfinished.fetch_sub(1) == 1)
+                    {
+                        std::lock_guard<std::mutex> lock(state_mutex);
+                        all_idle.notify_all();
+                    }
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(state_mutex);
+                work_available.wait(lock, [this]()
+                                    { return stopping || queued.load() > 0; });
+                if (stopping && queued.load() == 0)
+                {
+                    return;
+                }
+            }
+        }
+    };
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "util/trace/Tracer.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace util
+{
+    namespace concurrency
+    {
+        // Fixed-size work-stealing pool. Every worker owns a deque: it pops its own
+        // newest task first and steals the oldest task of a sibling when it runs dry,
+        // so tasks submitted from inside a task stay on the submitting worker.
+        class ThreadPool
+        {
+        public:
+            explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency());
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool &) = delete;
+            ThreadPool &operator=(const ThreadPool &) = delete;
+
+            template <typename F>
+            std::future<std::invoke_result_t<F>> Submit(F &&task)
+            {
+                using Result = std::invoke_result_t<F>;
+                auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+                std::future<Result> future = packaged->get_future();
+                // Tasks run inside the trace of whoever submitted them
+                Enqueue([packaged, context = util::trace::CurrentContext()]()
+                        {
+                    util::trace::ScopedContext scope(context);
+                    (*packaged)(); });
+                return future;
+            }
+
+            // Blocks until every submitted task, including tasks they submitted, has
+            // finished. Must not be called from a worker thread.
+            void WaitIdle();
+
+            size_t Size() const { return workers.size(); }
+
+        private:
+            struct WorkQueue
+            {
+                std::mutex mutex;
+                std::deque<std::function<void()>> tasks;
+            };
+
+            void Enqueue(std::function<void()> task);
+            bool TryPop(size_t index, std::function<void()> &task);
+            bool TrySteal(size_t thief, std::function<void()> &task);
+            void WorkerLoop(size_t index);
+
+            std::vector<std::unique_ptr<WorkQueue>> queues;
+            std::vector<std::thread> workers;
+
+            std::mutex state_mutex;
+            std::condition_variable work_available;
+            std::condition_variable all_idle;
+            std::atomic<size_t> queued{0};
+            std::atomic<size_t> unfinished{0};
+            std::atomic<size_t> next_queue{0};
+            bool stopping = false;
+        };
+    };
+};
@@ -0,0 +1,76 @@
+#include "RequestContext.hpp"
+
+#include <algorithm>
+
+namespace util
+{
+    namespace context
+    {
+        const RequestContext &RequestContext::Background()
+        {
+            static const RequestContext background;
+            return background;
+        }
+
+        RequestContext RequestContext::WithTimeout(std::chrono::milliseconds budget, Clock::time_point start)
+        {
+            RequestContext context;
+            context.state = std::make_shared<State>();
+            context.state->has_deadline = true;
+            context.state->start = start;
+            context.state->deadline = start + budget;
+            return context;
+        }
+
+        RequestContext::Clock::time_point RequestContext::Deadline() const
+        {
+            return HasDeadline() ? state->deadline : Clock::time_point::max();
+        }
+
+        std::chrono::milliseconds RequestContext::Remaining() const
+        {
+            if (!HasDeadline())
+            {
+                return std::chrono::milliseconds::max();
+            }
+            // Rounded up, so a timeout set from it never fires before Done() is true
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(state->deadline - Clock::now());
+            return std::max(remaining, std::chrono::milliseconds(0));
+        }
+
+        double RequestContext::RemainingFraction() const
+        {
+            if (!HasDeadline())
+            {
+                return 1.0;
+            }
+            const double budget = std::chrono::duration<double>(state->deadline - state->start).count();
+            if (budget <= 0.0)
+            {
+                return 0.0;
+            }
+            const double remaining = std::chrono::duration<double>(state->deadline - Clock::now()).count();
+            return std::clamp(remaining / budget, 0.0, 1.0);
+        }
+
+        void RequestContext::Cancel() const
+        {
+            if (state != nullptr)
+            {
+                state->cancelled.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        void RequestContext::ThrowIfDone(const char *stage) const
+        {
+            if (Cancelled())
+            {
+                throw DeadlineExceeded(std::string(stage) + ": request cancelled");
+            }
+            if (Done())
+            {
+                throw DeadlineExceeded(std::string(stage) + ": deadline exceeded");
+            }
+        }
+    };
+};
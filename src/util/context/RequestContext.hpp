@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace util
+{
+    namespace context
+    {
+        // Thrown by a stage that could not finish before the deadline or was cancelled
+        class DeadlineExceeded : public std::runtime_error
+        {
+        public:
+            using std::runtime_error::runtime_error;
+        };
+
+        // Deadline and cancellation for one request, passed down every call it makes.
+        // Copies share state, so Cancel() on any copy stops work started from the others.
+        class RequestContext
+        {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            // No deadline and never cancelled
+            static const RequestContext &Background();
+            static RequestContext WithTimeout(std::chrono::milliseconds budget, Clock::time_point start = Clock::now());
+
+            bool HasDeadline() const { return state != nullptr && state->has_deadline; }
+            // Background() can never be cancelled, so callers may skip polling it
+            bool Cancellable() const { return state != nullptr; }
+            Clock::time_point Deadline() const;
+
+            // Zero once expired; milliseconds::max() without a deadline
+            std::chrono::milliseconds Remaining() const;
+            // Share of the original budget still left, in [0, 1]; 1 without a deadline
+            double RemainingFraction() const;
+
+            // Only contexts made by WithTimeout() can be cancelled
+            void Cancel() const;
+            bool Cancelled() const { return state != nullptr && state->cancelled.load(std::memory_order_relaxed); }
+            bool Done() const { return Cancelled() || (HasDeadline() && Clock::now() >= state->deadline); }
+
+            // Throws DeadlineExceeded naming `stage` if the request is done
+            void ThrowIfDone(const char *stage) const;
+
+        private:
+            struct State
+            {
+                bool has_deadline = false;
+                Clock::time_point start;
+                Clock::time_point deadline;
+                std::atomic<bool> cancelled{false};
+            };
+
+            std::shared_ptr<State> state;
+        };
+    };
+};
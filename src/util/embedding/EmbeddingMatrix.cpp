@@ -0,0 +1,239 @@
+#include "EmbeddingMatrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace util
+{
+    namespace embedding
+    {
+        namespace
+        {
+            constexpr size_t kFloatsPerLine = kRowAlignment / sizeof(float);
+            constexpr size_t kLanes = 8;
+
+            size_t PaddedStride(size_t dimension)
+            {
+                return (dimension + kFloatsPerLine - 1) / kFloatsPerLine * kFloatsPerLine;
+            }
+
+            float *AllocateRows(size_t stride, size_t row_capacity)
+            {
+                if (stride == 0 || row_capacity == 0)
+                {
+                    return nullptr;
+                }
+                return static_cast<float *>(::operator new(stride * row_capacity * sizeof(float), std::align_val_t(kRowAlignment)));
+            }
+
+            // Independent accumulators break the add dependency chain so the
+            // compiler can keep several vector registers busy
+            template <size_t Dimension>
+            float DotFixed(const float *lhs, const float *rhs)
+            {
+                static_assert(Dimension % kLanes == 0, "fixed kernels need a multiple of the lane count");
+                float sums[kLanes] = {};
+                for (size_t i = 0; i < Dimension; i += kLanes)
+                {
+                    for (size_t lane = 0; lane < kLanes; ++lane)
+                    {
+                        sums[lane] += lhs[i + lane] * rhs[i + lane];
+                    }
+                }
+                float total = 0.0f;
+                for (const float sum : sums)
+                {
+                    total += sum;
+                }
+                return total;
+            }
+
+            float DotGeneric(const float *lhs, const float *rhs, size_t dimension)
+            {
+                float sums[kLanes] = {};
+                size_t i = 0;
+                for (; i + kLanes <= dimension; i += kLanes)
+                {
+                    for (size_t lane = 0; lane < kLanes; ++lane)
+                    {
+                        sums[lane] += lhs[i + lane] * rhs[i + lane];
+                    }
+                }
+                float total = 0.0f;
+                for (const float sum : sums)
+                {
+                    total += sum;
+                }
+                for (; i < dimension; ++i)
+                {
+                    total += lhs[i] * rhs[i];
+                }
+                return total;
+            }
+
+            float DotKernel(const float *lhs, const float *rhs, size_t dimension)
+            {
+                switch (dimension)
+                {
+                case 384:
+                    return DotFixed<384>(lhs, rhs);
+                case 768:
+                    return DotFixed<768>(lhs, rhs);
+                case 1024:
+                    return DotFixed<1024>(lhs, rhs);
+                default:
+                    return DotGeneric(lhs, rhs, dimension);
+                }
+            }
+
+            void Scale(float *values, size_t dimension, float factor)
+            {
+                for (size_t i = 0; i < dimension; ++i)
+                {
+                    values[i] *= factor;
+                }
+            }
+        }
+
+        void EmbeddingMatrix::AlignedDelete::operator()(float *block) const
+        {
+            ::operator delete(block, std::align_val_t(kRowAlignment));
+        }
+
+        EmbeddingMatrix::EmbeddingMatrix(size_t dimension, size_t rows)
+            : dimension(dimension), stride(PaddedStride(dimension))
+        {
+            Resize(rows);
+        }
+
+        EmbeddingMatrix::EmbeddingMatrix(const EmbeddingMatrix &other)
+            : dimension(other.dimension), stride(other.stride)
+        {
+            Reserve(other.rows);
+            rows = other.rows;
+            if (rows > 0)
+            {
+                std::memcpy(storage.get(), other.storage.get(), rows * stride * sizeof(float));
+            }
+        }
+
+        EmbeddingMatrix::EmbeddingMatrix(EmbeddingMatrix &&other) noexcept
+            : dimension(other.dimension),
+              stride(other.stride),
+              rows(other.rows),
+              capacity(other.capacity),
+              storage(std::move(other.storage))
+        {
+            other.rows = 0;
+            other.capacity = 0;
+        }
+
+        void EmbeddingMatrix::Reserve(size_t row_capacity)
+        {
+            if (row_capacity <= capacity)
+            {
+                return;
+            }
+
+            std::unique_ptr<float[], AlignedDelete> grown(AllocateRows(stride, row_capacity));
+            if (rows > 0)
+            {
+                std::memcpy(grown.get(), storage.get(), rows * stride * sizeof(float));
+            }
+            storage = std::move(grown);
+            capacity = row_capacity;
+        }
+
+        void EmbeddingMatrix::Resize(size_t row_count)
+        {
+            Reserve(row_count);
+            if (row_count > rows)
+            {
+                std::fill(storage.get() + rows * stride, storage.get() + row_count * stride, 0.0f);
+            }
+            rows = row_count;
+        }
+
+        RowView EmbeddingMatrix::AppendRow()
+        {
+            if (rows == capacity)
+            {
+                Reserve(std::max<size_t>(8, capacity * 2));
+            }
+            std::fill(storage.get() + rows * stride, storage.get() + (rows + 1) * stride, 0.0f);
+            return Row(rows++);
+        }
+
+        void EmbeddingMatrix::AppendRow(ConstRowView values)
+        {
+            if (values.size() != dimension)
+            {
+                throw std::runtime_error("Embedding has dimension " + std::to_string(values.size()) +
+                                         ", expected " + std::to_string(dimension));
+            }
+            std::copy(values.begin(), values.end(), AppendRow().begin());
+        }
+
+        void EmbeddingMatrix::SwapRemoveRow(size_t index)
+        {
+            if (index + 1 < rows)
+            {
+                std::memcpy(storage.get() + index * stride, storage.get() + (rows - 1) * stride, stride * sizeof(float));
+            }
+            --rows;
+        }
+
+        void EmbeddingMatrix::NormalizeRows()
+        {
+            for (size_t row = 0; row < rows; ++row)
+            {
+                Normalize(Row(row));
+            }
+        }
+
+        float Dot(ConstRowView lhs, ConstRowView rhs)
+        {
+            if (lhs.size() != rhs.size())
+            {
+                throw std::runtime_error("Embedding dimensions differ: " + std::to_string(lhs.size()) +
+                                         " and " + std::to_string(rhs.size()));
+            }
+            return DotKernel(lhs.data(), rhs.data(), lhs.size());
+        }
+
+        float Norm(ConstRowView values)
+        {
+            return std::sqrt(DotKernel(values.data(), values.data(), values.size()));
+        }
+
+        void Normalize(RowView values)
+        {
+            const float norm = Norm(values);
+            if (norm > 0.0f)
+            {
+                Scale(values.data(), values.size(), 1.0f / norm);
+            }
+        }
+
+        std::vector<float> ScoreRows(const EmbeddingMatrix &matrix, ConstRowView query)
+        {
+            if (query.size() != matrix.Dimension())
+            {
+                throw std::runtime_error("Query has dimension " + std::to_string(query.size()) +
+                                         ", expected " + std::to_string(matrix.Dimension()));
+            }
+
+            std::vector<float> scores(matrix.Rows());
+            const float *row = matrix.Data();
+            for (size_t i = 0; i < scores.size(); ++i, row += matrix.Stride())
+            {
+                scores[i] = DotKernel(row, query.data(), query.size());
+            }
+            return scores;
+        }
+    };
+};
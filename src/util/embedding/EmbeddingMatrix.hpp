@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace util
+{
+    namespace embedding
+    {
+        // Every row starts on a cache line, so SIMD loads never straddle two
+        constexpr size_t kRowAlignment = 64;
+
+        // Non-owning view of one embedding. A const view also binds to a
+        // std::vector<float>, so single query vectors need no matrix.
+        template <typename T>
+        class BasicRowView
+        {
+        public:
+            BasicRowView() = default;
+            BasicRowView(T *values, size_t count) : values(values), count(count) {}
+
+            template <typename U, typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+            BasicRowView(const BasicRowView<U> &other) : values(other.data()), count(other.size()) {}
+
+            template <typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+            BasicRowView(const std::vector<float> &values) : values(values.data()), count(values.size()) {}
+
+            T *data() const { return values; }
+            size_t size() const { return count; }
+            bool empty() const { return count == 0; }
+            T &operator[](size_t index) const { return values[index]; }
+            T *begin() const { return values; }
+            T *end() const { return values + count; }
+
+        private:
+            T *values = nullptr;
+            size_t count = 0;
+        };
+
+        using RowView = BasicRowView<float>;
+        using ConstRowView = BasicRowView<const float>;
+
+        // Row-major block of embeddings sharing one dimension, held in a single
+        // 64-byte aligned allocation. Rows are padded to a multiple of 16 floats;
+        // for the usual model sizes (384/768/1024) the padding is zero.
+        class EmbeddingMatrix
+        {
+        public:
+            explicit EmbeddingMatrix(size_t dimension = 0, size_t rows = 0);
+
+            // The dimension is fixed at construction, so matrices are copied or
+            // moved into new objects but never assigned over one another
+            EmbeddingMatrix(const EmbeddingMatrix &other);
+            EmbeddingMatrix &operator=(const EmbeddingMatrix &other) = delete;
+            EmbeddingMatrix(EmbeddingMatrix &&other) noexcept;
+            EmbeddingMatrix &operator=(EmbeddingMatrix &&other) = delete;
+
+            size_t Rows() const { return rows; }
+            size_t Dimension() const { return dimension; }
+            size_t Stride() const { return stride; } // floats between row starts
+            bool Empty() const { return rows == 0; }
+
+            RowView Row(size_t index) { return RowView(storage.get() + index * stride, dimension); }
+            ConstRowView Row(size_t index) const { return ConstRowView(storage.get() + index * stride, dimension); }
+
+            float *Data() { return storage.get(); }
+            const float *Data() const { return storage.get(); }
+
+            void Reserve(size_t row_capacity);
+            // New rows are zero-filled
+            void Resize(size_t row_count);
+            RowView AppendRow();
+            // Throws if values.size() differs from the dimension
+            void AppendRow(ConstRowView values);
+            // Moves the last row into the freed slot; row order is not kept
+            void SwapRemoveRow(size_t index);
+
+            void NormalizeRows();
+
+        private:
+            struct AlignedDelete
+            {
+                void operator()(float *block) const;
+            };
+
+            size_t dimension;
+            size_t stride;
+            size_t rows = 0;
+            size_t capacity = 0;
+            std::unique_ptr<float[], AlignedDelete> storage;
+        };
+
+        // Kernels are unrolled at compile time for 384, 768 and 1024 dimensions and
+        // fall back to a generic loop otherwise.
+        float Dot(ConstRowView lhs, ConstRowView rhs);
+        float Norm(ConstRowView values);
+        // Scales to unit length; zero vectors are left untouched
+        void Normalize(RowView values);
+
+        // scores[i] = Dot(matrix.Row(i), query), for cosine ranking of normalized rows
+        std::vector<float> ScoreRows(const EmbeddingMatrix &matrix, ConstRowView query);
+    };
+};
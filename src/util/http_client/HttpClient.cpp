@@ -1,7 +1,10 @@
 #include "HttpClient.hpp"
 
+#include "util/trace/Tracer.hpp"
+
 #include <curl/curl.h>
 
+#include <algorithm>
 #include <cctype>
 #include <memory>
 #include <sstream>
@@ -77,16 +80,25 @@ namespace util
                 return base + path;
             }
 
+            int AbortIfCancelled(void *userdata, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+            {
+                return static_cast<const context::RequestContext *>(userdata)->Cancelled() ? 1 : 0;
+            }
+
             HttpResponse PerformRequest(const std::string &method,
                                         const std::string &url,
-                                        const std::optional<std::string> &json_body)
+                                        std::optional<std::string_view> json_body,
+                                        const context::RequestContext &context)
             {
                 HttpResponse response;
                 response.request_method = method;
                 response.request_url = url;
-                if (json_body.has_value())
+
+                // Nobody is waiting for the answer any more
+                if (context.Done())
                 {
-                    response.request_body = *json_body;
+                    response.error = context.Cancelled() ? "request cancelled" : "deadline exceeded";
+                    return response;
                 }
 
                 CURL *curl = curl_easy_init();
@@ -104,6 +116,19 @@ namespace util
                 curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
                 curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, WriteHeader);
                 curl_easy_setopt(curl, CURLOPT_HEADERDATA, &headers);
+                // Requests run concurrently from worker threads; signals are not thread-safe.
+                curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+                if (context.HasDeadline())
+                {
+                    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(std::max<long long>(1, context.Remaining().count())));
+                }
+                if (context.Cancellable())
+                {
+                    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, AbortIfCancelled);
+                    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &context);
+                    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+                }
 
                 curl_slist *raw_headers = nullptr;
                 raw_headers = curl_slist_append(raw_headers, "Accept: application/json");
@@ -120,46 +145,117 @@ namespace util
 
                 if ((method == "POST" || method == "PUT") && json_body.has_value())
                 {
-                    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_body->c_str());
-                    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, json_body->size());
+                    // Sent straight from the caller's buffer; POSTFIELDSIZE means it need not be NUL-terminated
+                    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_body->data());
+                    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(json_body->size()));
                 }
 
                 const CURLcode code = curl_easy_perform(curl);
                 if (code == CURLE_OK)
                 {
                     curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.status_code);
-                    response.body = body;
+                    response.body = std::move(body);
                     response.headers = std::move(headers);
                 }
+                else
+                {
+                    response.error = code == CURLE_ABORTED_BY_CALLBACK ? "request cancelled" : curl_easy_strerror(code);
+                    response.not_sent = code == CURLE_COULDNT_RESOLVE_HOST || code == CURLE_COULDNT_CONNECT;
+                }
+
+                // Bodies can be large; copy one only when it helps explain a failure
+                if ((response.status_code < 200 || response.status_code >= 300) && json_body.has_value())
+                {
+                    response.request_body = std::string(*json_body);
+                }
 
                 curl_easy_cleanup(curl);
                 return response;
             }
 
+            // Outcomes that say something about the replica rather than the request
+            bool IsReplicaFailure(const HttpResponse &response)
+            {
+                return response.status_code == 0 || response.status_code >= 500;
+            }
+
         } // namespace
 
         HttpClient::HttpClient(std::string base_url) : base_url_(std::move(base_url)) {}
 
-        HttpResponse HttpClient::Get(const std::string &path) const
+        HttpClient::HttpClient(std::shared_ptr<ReplicaSet> replicas) : replicas_(std::move(replicas)) {}
+
+        HttpClient HttpClient::FromUrlList(const std::string &urls, BalancingPolicy policy)
+        {
+            std::vector<std::string> split = ReplicaSet::SplitUrls(urls);
+            if (split.size() <= 1)
+            {
+                return HttpClient(split.empty() ? urls : split.front());
+            }
+            return HttpClient(std::make_shared<ReplicaSet>(std::move(split), policy));
+        }
+
+        HttpResponse HttpClient::Send(const std::string &method,
+                                      const std::string &path,
+                                      std::optional<std::string_view> json_body,
+                                      const context::RequestContext &context) const
+        {
+            if (!replicas_)
+            {
+                return PerformRequest(method, JoinUrl(base_url_, path), json_body, context);
+            }
+
+            // A transfer the caller cancelled says nothing about the replica. A timeout
+            // does: a replica that accepts connections and then hangs must still be ejected.
+            const auto finish = [&context](ReplicaSet::Lease &lease, const HttpResponse &response)
+            {
+                if (response.status_code == 0 && context.Cancelled())
+                    lease.Discard();
+                else
+                    lease.Complete(!IsReplicaFailure(response));
+            };
+
+            ReplicaSet::Lease lease = replicas_->Acquire();
+            HttpResponse response = PerformRequest(method, JoinUrl(lease.Url(), path), json_body, context);
+            finish(lease, response);
+
+            // Only a request that never reached the replica is safe to send again: after a
+            // timeout or a dropped connection an upsert or a completion may already have run
+            if (response.not_sent && !context.Done() && replicas_->Size() > 1)
+            {
+                ReplicaSet::Lease retry = replicas_->Acquire(lease.Index());
+                response = PerformRequest(method, JoinUrl(retry.Url(), path), json_body, context);
+                finish(retry, response);
+            }
+            return response;
+        }
+
+        HttpResponse HttpClient::Get(const std::string &path, const context::RequestContext &context) const
         {
-            return PerformRequest("GET", JoinUrl(base_url_, path), std::nullopt);
+            util::trace::ScopedSpan span("http.get", path);
+            return Send("GET", path, std::nullopt, context);
         }
 
         HttpResponse HttpClient::Post(const std::string &path,
-                                      const std::optional<std::string> &json_body) const
+                                      std::optional<std::string_view> json_body,
+                                      const context::RequestContext &context) const
         {
-            return PerformRequest("POST", JoinUrl(base_url_, path), json_body);
+            util::trace::ScopedSpan span("http.post", path);
+            return Send("POST", path, json_body, context);
         }
 
         HttpResponse HttpClient::Put(const std::string &path,
-                                     const std::optional<std::string> &json_body) const
+                                     std::optional<std::string_view> json_body,
+                                     const context::RequestContext &context) const
         {
-            return PerformRequest("PUT", JoinUrl(base_url_, path), json_body);
+            util::trace::ScopedSpan span("http.put", path);
+            return Send("PUT", path, json_body, context);
         }
 
-        HttpResponse HttpClient::Delete(const std::string &path) const
+        HttpResponse HttpClient::Delete(const std::string &path, const context::RequestContext &context) const
         {
-            return PerformRequest("DELETE", JoinUrl(base_url_, path), std::nullopt);
+            util::trace::ScopedSpan span("http.delete", path);
+            return Send("DELETE", path, std::nullopt, context);
         }
 
     } // namespace http
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "ReplicaSet.hpp"
+#include "util/context/RequestContext.hpp"
+
 #include <stdexcept>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace util
 {
@@ -18,13 +23,16 @@ namespace util
             std::map<std::string, std::string> headers;
             std::string request_url;
             std::string request_method;
-            std::string request_body;
+            std::string request_body; // only kept for failed requests
+            std::string error;        // why no status arrived (timeout, refused, cancelled)
+            bool not_sent = false;    // no connection was made, so the server never saw the request
 
             void ThrowErrorIfFailed() const
             {
                 if (status_code < 200 || status_code >= 300)
                 {
-                    throw std::runtime_error("HTTP request failed with status code " + std::to_string(status_code) + ": " + body);
+                    throw std::runtime_error("HTTP request failed with status code " + std::to_string(status_code) + ": " +
+                                             (status_code == 0 ? error : body));
                 }
             }
         };
@@ -33,16 +41,33 @@ namespace util
         {
         public:
             explicit HttpClient(std::string base_url);
+            // Spreads requests over interchangeable servers; paths are appended to each replica's URL
+            explicit HttpClient(std::shared_ptr<ReplicaSet> replicas);
+
+            // One URL gives a plain client; a comma-separated list gives a balanced one
+            static HttpClient FromUrlList(const std::string &urls, BalancingPolicy policy = BalancingPolicy::LeastOutstanding);
 
-            HttpResponse Get(const std::string &path) const;
+            // The context's remaining budget becomes the transfer timeout, and cancelling
+            // it aborts the transfer within about a second.
+            HttpResponse Get(const std::string &path,
+                             const context::RequestContext &context = context::RequestContext::Background()) const;
             HttpResponse Post(const std::string &path,
-                              const std::optional<std::string> &json_body = std::nullopt) const;
+                              std::optional<std::string_view> json_body = std::nullopt,
+                              const context::RequestContext &context = context::RequestContext::Background()) const;
             HttpResponse Put(const std::string &path,
-                             const std::optional<std::string> &json_body = std::nullopt) const;
-            HttpResponse Delete(const std::string &path) const;
+                             std::optional<std::string_view> json_body = std::nullopt,
+                             const context::RequestContext &context = context::RequestContext::Background()) const;
+            HttpResponse Delete(const std::string &path,
+                                const context::RequestContext &context = context::RequestContext::Background()) const;
 
         private:
+            HttpResponse Send(const std::string &method,
+                              const std::string &path,
+                              std::optional<std::string_view> json_body,
+                              const context::RequestContext &context) const;
+
             std::string base_url_;
+            std::shared_ptr<ReplicaSet> replicas_;
         };
 
     };
@@ -0,0 +1,279 @@
+#include "ReplicaSet.hpp"
+
+#include "HttpClient.hpp"
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace util
+{
+    namespace http
+    {
+        namespace
+        {
+            std::chrono::milliseconds Backoff(const ReplicaHealthOptions &options, unsigned int ejections)
+            {
+                std::chrono::milliseconds delay = options.ejection;
+                for (unsigned int i = 1; i < ejections && delay < options.max_ejection; ++i)
+                {
+                    delay *= 2;
+                }
+                return std::min(delay, options.max_ejection);
+            }
+
+            size_t RandomBelow(size_t bound)
+            {
+                thread_local std::minstd_rand generator(std::random_device{}());
+                return std::uniform_int_distribution<size_t>(0, bound - 1)(generator);
+            }
+        }
+
+        BalancingPolicy ParseBalancingPolicy(const std::string &name)
+        {
+            if (name == "least-outstanding")
+                return BalancingPolicy::LeastOutstanding;
+            if (name == "power-of-two")
+                return BalancingPolicy::PowerOfTwoChoices;
+            throw std::runtime_error("Unknown balancing policy: " + name);
+        }
+
+        ReplicaSet::ReplicaSet(std::vector<std::string> urls, BalancingPolicy policy, ReplicaHealthOptions options)
+            : policy(policy), options(std::move(options))
+        {
+            if (urls.empty())
+            {
+                throw std::runtime_error("A replica set needs at least one URL");
+            }
+            replicas.resize(urls.size());
+            for (size_t i = 0; i < urls.size(); ++i)
+            {
+                replicas[i].url = std::move(urls[i]);
+            }
+            prober = std::thread([this]()
+                                 { ProbeLoop(); });
+        }
+
+        ReplicaSet::~ReplicaSet()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            probe_wakeup.notify_all();
+            prober.join();
+        }
+
+        std::vector<std::string> ReplicaSet::SplitUrls(const std::string &list)
+        {
+            std::vector<std::string> urls;
+            std::istringstream entries(list);
+            std::string entry;
+            while (std::getline(entries, entry, ','))
+            {
+                entry.erase(0, entry.find_first_not_of(" \t"));
+                entry.erase(entry.find_last_not_of(" \t") + 1);
+                if (!entry.empty())
+                {
+                    urls.push_back(entry);
+                }
+            }
+            return urls;
+        }
+
+        ReplicaSet::Lease::Lease(Lease &&other) noexcept
+            : set(other.set), index(other.index), url(other.url)
+        {
+            other.set = nullptr;
+        }
+
+        ReplicaSet::Lease::~Lease()
+        {
+            if (set != nullptr)
+            {
+                set->Release(index, true, false);
+            }
+        }
+
+        void ReplicaSet::Lease::Complete(bool succeeded)
+        {
+            if (set != nullptr)
+            {
+                set->Release(index, true, succeeded);
+                set = nullptr;
+            }
+        }
+
+        void ReplicaSet::Lease::Discard()
+        {
+            if (set != nullptr)
+            {
+                set->Release(index, false, false);
+                set = nullptr;
+            }
+        }
+
+        bool ReplicaSet::Eligible(size_t index, size_t avoid) const
+        {
+            return !replicas[index].ejected && index != avoid;
+        }
+
+        ReplicaSet::Lease ReplicaSet::Acquire(size_t avoid)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            std::vector<size_t> candidates;
+            candidates.reserve(replicas.size());
+            for (size_t i = 0; i < replicas.size(); ++i)
+            {
+                if (Eligible(i, avoid))
+                {
+                    candidates.push_back(i);
+                }
+            }
+            if (candidates.empty() && avoid < replicas.size() && !replicas[avoid].ejected)
+            {
+                candidates.push_back(avoid);
+            }
+
+            size_t chosen;
+            if (candidates.empty())
+            {
+                // Everything is ejected: fail open to the replica due back soonest
+                chosen = 0;
+                for (size_t i = 1; i < replicas.size(); ++i)
+                {
+                    if (replicas[i].probe_at < replicas[chosen].probe_at)
+                    {
+                        chosen = i;
+                    }
+                }
+            }
+            else if (policy == BalancingPolicy::PowerOfTwoChoices && candidates.size() > 1)
+            {
+                const size_t first = RandomBelow(candidates.size());
+                size_t second = RandomBelow(candidates.size() - 1);
+                if (second >= first)
+                {
+                    ++second;
+                }
+                chosen = replicas[candidates[second]].outstanding < replicas[candidates[first]].outstanding
+                             ? candidates[second]
+                             : candidates[first];
+            }
+            else
+            {
+                // Start the scan at a rotating offset so ties spread across replicas
+                const size_t start = rotation++ % candidates.size();
+                chosen = candidates[start];
+                for (size_t n = 1; n < candidates.size(); ++n)
+                {
+                    const size_t index = candidates[(start + n) % candidates.size()];
+                    if (replicas[index].outstanding < replicas[chosen].outstanding)
+                    {
+                        chosen = index;
+                    }
+                }
+            }
+
+            ++replicas[chosen].outstanding;
+            return Lease(this, chosen);
+        }
+
+        size_t ReplicaSet::HealthyCount() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return static_cast<size_t>(std::count_if(replicas.begin(), replicas.end(), [](const Replica &replica)
+                                                     { return !replica.ejected; }));
+        }
+
+        void ReplicaSet::Release(size_t index, bool counted, bool succeeded)
+        {
+            bool ejected_now = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                Replica &replica = replicas[index];
+                --replica.outstanding;
+                if (!counted)
+                {
+                    return;
+                }
+
+                if (succeeded)
+                {
+                    // A success while ejected (we failed open to it) is as good as a probe
+                    replica.consecutive_failures = 0;
+                    replica.ejections = 0;
+                    replica.ejected = false;
+                    return;
+                }
+
+                ++replica.consecutive_failures;
+                if (!replica.ejected && replica.consecutive_failures >= options.failure_threshold)
+                {
+                    replica.ejected = true;
+                    ++replica.ejections;
+                    replica.probe_at = Clock::now() + Backoff(options, replica.ejections);
+                    ejected_now = true;
+                }
+            }
+            if (ejected_now)
+            {
+                probe_wakeup.notify_all();
+            }
+        }
+
+        void ReplicaSet::ProbeLoop()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!stopping)
+            {
+                size_t due = replicas.size();
+                for (size_t i = 0; i < replicas.size(); ++i)
+                {
+                    if (replicas[i].ejected && (due == replicas.size() || replicas[i].probe_at < replicas[due].probe_at))
+                    {
+                        due = i;
+                    }
+                }
+
+                if (due == replicas.size())
+                {
+                    probe_wakeup.wait(lock);
+                    continue;
+                }
+                if (Clock::now() < replicas[due].probe_at)
+                {
+                    probe_wakeup.wait_until(lock, replicas[due].probe_at);
+                    continue;
+                }
+
+                const std::string url = replicas[due].url;
+                lock.unlock();
+                // Bounded, so one stalled replica cannot stop the prober or hang shutdown
+                const long status_code = HttpClient(url)
+                                             .Get(options.probe_path, context::RequestContext::WithTimeout(options.probe_timeout))
+                                             .status_code;
+                lock.lock();
+
+                Replica &replica = replicas[due];
+                if (!replica.ejected)
+                {
+                    continue;
+                }
+                if (status_code >= 200 && status_code < 300)
+                {
+                    // Back in rotation; the ejection count only resets after a real request succeeds
+                    replica.ejected = false;
+                    replica.consecutive_failures = 0;
+                }
+                else
+                {
+                    ++replica.ejections;
+                    replica.probe_at = Clock::now() + Backoff(options, replica.ejections);
+                }
+            }
+        }
+    };
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+    namespace http
+    {
+        enum class BalancingPolicy
+        {
+            LeastOutstanding,  // fewest in-flight requests, ties rotated
+            PowerOfTwoChoices, // the less loaded of two random replicas
+        };
+
+        // "least-outstanding" or "power-of-two"
+        BalancingPolicy ParseBalancingPolicy(const std::string &name);
+
+        struct ReplicaHealthOptions
+        {
+            unsigned int failure_threshold = 3;         // consecutive failures before ejection
+            std::chrono::milliseconds ejection{2000};   // first ejection; doubles per repeat, up to max_ejection
+            std::chrono::milliseconds max_ejection{60000};
+            std::string probe_path = "/health";         // must answer 2xx before a replica is reintroduced
+            std::chrono::milliseconds probe_timeout{1000}; // a probe that takes longer counts as failed
+        };
+
+        // Interchangeable servers behind one logical endpoint. Health is tracked
+        // passively from request outcomes: a replica that keeps failing is ejected,
+        // and a background prober brings it back once its health check passes.
+        class ReplicaSet
+        {
+        public:
+            ReplicaSet(std::vector<std::string> urls,
+                       BalancingPolicy policy = BalancingPolicy::LeastOutstanding,
+                       ReplicaHealthOptions options = {});
+            ~ReplicaSet();
+
+            ReplicaSet(const ReplicaSet &) = delete;
+            ReplicaSet &operator=(const ReplicaSet &) = delete;
+
+            // Splits a comma-separated URL list, dropping blanks.
+            static std::vector<std::string> SplitUrls(const std::string &list);
+
+            // One routed request; counts as outstanding until Complete() or destruction
+            // (which counts as a failure).
+            class Lease
+            {
+            public:
+                Lease(Lease &&other) noexcept;
+                Lease &operator=(Lease &&) = delete;
+                ~Lease();
+
+                const std::string &Url() const { return *url; }
+                size_t Index() const { return index; }
+                void Complete(bool succeeded);
+                // Stops counting as outstanding without affecting health, for requests
+                // abandoned by the caller rather than failed by the replica
+                void Discard();
+
+            private:
+                friend class ReplicaSet;
+                Lease(ReplicaSet *set, size_t index) : set(set), index(index), url(&set->replicas[index].url) {}
+
+                ReplicaSet *set; // null once completed
+                size_t index;
+                const std::string *url;
+            };
+
+            // Healthy replicas are preferred; if every replica is ejected the one due
+            // back soonest is used rather than failing outright. `avoid` (an index)
+            // is skipped when any other replica can take the request.
+            Lease Acquire(size_t avoid = static_cast<size_t>(-1));
+
+            size_t Size() const { return replicas.size(); }
+            size_t HealthyCount() const;
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            struct Replica
+            {
+                std::string url;
+                size_t outstanding = 0;
+                unsigned int consecutive_failures = 0;
+                unsigned int ejections = 0; // in a row; reset once a request succeeds
+                bool ejected = false;
+                Clock::time_point probe_at;
+            };
+
+            void Release(size_t index, bool counted, bool succeeded);
+            bool Eligible(size_t index, size_t avoid) const;
+            void ProbeLoop();
+
+            std::vector<Replica> replicas;
+            BalancingPolicy policy;
+            ReplicaHealthOptions options;
+            size_t rotation = 0;
+
+            mutable std::mutex mutex;
+            std::condition_variable probe_wakeup;
+            bool stopping = false;
+            std::thread prober;
+        };
+    };
+};
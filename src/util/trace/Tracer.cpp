@@ -0,0 +1,256 @@
+#include "Tracer.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using json = nlohmann::json;
+
+namespace util
+{
+    namespace trace
+    {
+        namespace
+        {
+            constexpr size_t kRingCapacity = 1 << 12;
+
+            // Written only by its owning thread; the mutex is uncontended except
+            // while an export is copying the buffer.
+            struct RingBuffer
+            {
+                std::mutex mutex;
+                std::vector<SpanRecord> records;
+                size_t next = 0;
+                bool wrapped = false;
+                uint32_t thread_index = 0;
+            };
+
+            struct Registry
+            {
+                std::mutex mutex;
+                std::vector<std::shared_ptr<RingBuffer>> buffers;
+            };
+
+            Registry &GetRegistry()
+            {
+                static Registry registry;
+                return registry;
+            }
+
+            RingBuffer &LocalBuffer()
+            {
+                thread_local std::shared_ptr<RingBuffer> buffer = []()
+                {
+                    auto created = std::make_shared<RingBuffer>();
+                    created->records.resize(kRingCapacity);
+                    Registry &registry = GetRegistry();
+                    std::lock_guard<std::mutex> lock(registry.mutex);
+                    created->thread_index = static_cast<uint32_t>(registry.buffers.size());
+                    registry.buffers.push_back(created);
+                    return created;
+                }();
+                return *buffer;
+            }
+
+            thread_local TraceContext current;
+
+            uint64_t NextId()
+            {
+                thread_local std::mt19937_64 generator(std::random_device{}() ^
+                                                       std::hash<std::thread::id>{}(std::this_thread::get_id()));
+                uint64_t id;
+                do
+                {
+                    id = generator();
+                } while (id == 0);
+                return id;
+            }
+
+            int64_t NowNs()
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+            }
+
+            // Offset turning steady-clock timestamps into Unix time for OTLP
+            int64_t UnixOffsetNs()
+            {
+                static const int64_t offset =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count() -
+                    NowNs();
+                return offset;
+            }
+
+            std::string Hex(uint64_t value, int width)
+            {
+                char buffer[33];
+                std::snprintf(buffer, sizeof(buffer), "%0*llx", width, static_cast<unsigned long long>(value));
+                return buffer;
+            }
+
+            bool WriteJson(const std::string &filepath, const json &document)
+            {
+                std::ofstream file(filepath);
+                if (!file.is_open())
+                {
+                    return false;
+                }
+                // Span details come from user input; replace invalid UTF-8 rather than throw
+                file << document.dump(-1, ' ', false, json::error_handler_t::replace);
+                return file.good();
+            }
+        }
+
+        void Enable(bool enabled)
+        {
+            UnixOffsetNs();
+            detail::enabled.store(enabled, std::memory_order_relaxed);
+        }
+
+        TraceContext CurrentContext()
+        {
+            return current;
+        }
+
+        std::vector<SpanRecord> CollectSpans()
+        {
+            std::vector<std::shared_ptr<RingBuffer>> buffers;
+            {
+                Registry &registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                buffers = registry.buffers;
+            }
+
+            std::vector<SpanRecord> spans;
+            for (const auto &buffer : buffers)
+            {
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                if (buffer->wrapped)
+                {
+                    spans.insert(spans.end(), buffer->records.begin() + buffer->next, buffer->records.end());
+                }
+                spans.insert(spans.end(), buffer->records.begin(), buffer->records.begin() + buffer->next);
+            }
+            return spans;
+        }
+
+        bool WriteChromeTrace(const std::string &filepath)
+        {
+            json events = json::array();
+            for (const auto &span : CollectSpans())
+            {
+                json args = {{"trace_id", Hex(span.trace_id, 16)},
+                             {"span_id", Hex(span.span_id, 16)}};
+                if (span.parent_span_id != 0)
+                {
+                    args["parent_span_id"] = Hex(span.parent_span_id, 16);
+                }
+                if (span.detail[0] != '\0')
+                {
+                    args["detail"] = span.detail;
+                }
+                events.push_back({{"name", span.name},
+                                  {"cat", "rag"},
+                                  {"ph", "X"},
+                                  {"ts", static_cast<double>(span.start_ns) / 1000.0},
+                                  {"dur", static_cast<double>(span.end_ns - span.start_ns) / 1000.0},
+                                  {"pid", 1},
+                                  {"tid", span.thread_index},
+                                  {"args", args}});
+            }
+            return WriteJson(filepath, {{"traceEvents", events}, {"displayTimeUnit", "ms"}});
+        }
+
+        bool WriteOtlpJson(const std::string &filepath, const std::string &service_name)
+        {
+            const int64_t offset = UnixOffsetNs();
+            json spans = json::array();
+            for (const auto &span : CollectSpans())
+            {
+                json attributes = json::array();
+                attributes.push_back({{"key", "thread.id"}, {"value", {{"intValue", std::to_string(span.thread_index)}}}});
+                if (span.detail[0] != '\0')
+                {
+                    attributes.push_back({{"key", "detail"}, {"value", {{"stringValue", span.detail}}}});
+                }
+
+                json otlp_span = {{"traceId", Hex(0, 16) + Hex(span.trace_id, 16)},
+                                  {"spanId", Hex(span.span_id, 16)},
+                                  {"name", span.name},
+                                  {"kind", 1},
+                                  {"startTimeUnixNano", std::to_string(span.start_ns + offset)},
+                                  {"endTimeUnixNano", std::to_string(span.end_ns + offset)},
+                                  {"attributes", attributes}};
+                if (span.parent_span_id != 0)
+                {
+                    otlp_span["parentSpanId"] = Hex(span.parent_span_id, 16);
+                }
+                spans.push_back(std::move(otlp_span));
+            }
+
+            json resource = {{"attributes", {{{"key", "service.name"}, {"value", {{"stringValue", service_name}}}}}}};
+            json scope_spans = {{"scope", {{"name", "rag"}}}, {"spans", spans}};
+            return WriteJson(filepath, {{"resourceSpans", {{{"resource", resource}, {"scopeSpans", {scope_spans}}}}}});
+        }
+
+        ScopedContext::ScopedContext(const TraceContext &context) : previous(current)
+        {
+            current = context;
+        }
+
+        ScopedContext::~ScopedContext()
+        {
+            current = previous;
+        }
+
+        void ScopedSpan::Begin(const char *name, std::string_view detail)
+        {
+            active = true;
+            previous = current;
+
+            record.name = name;
+            size_t length = std::min(detail.size(), sizeof(record.detail) - 1);
+            // Cut before a UTF-8 continuation byte so a multi-byte character is never split
+            while (length > 0 && length < detail.size() && (static_cast<unsigned char>(detail[length]) & 0xC0) == 0x80)
+            {
+                --length;
+            }
+            if (length > 0)
+            {
+                std::memcpy(record.detail, detail.data(), length);
+            }
+            record.detail[length] = '\0';
+            record.trace_id = previous.trace_id != 0 ? previous.trace_id : NextId();
+            record.span_id = NextId();
+            record.parent_span_id = previous.span_id;
+
+            current = TraceContext{record.trace_id, record.span_id};
+            record.start_ns = NowNs();
+        }
+
+        void ScopedSpan::End()
+        {
+            record.end_ns = NowNs();
+            current = previous;
+
+            RingBuffer &buffer = LocalBuffer();
+            record.thread_index = buffer.thread_index;
+            std::lock_guard<std::mutex> lock(buffer.mutex);
+            buffer.records[buffer.next] = record;
+            if (++buffer.next == buffer.records.size())
+            {
+                buffer.next = 0;
+                buffer.wrapped = true;
+            }
+        }
+    };
+};
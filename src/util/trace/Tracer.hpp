@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace util
+{
+    namespace trace
+    {
+        struct TraceContext
+        {
+            uint64_t trace_id = 0;
+            uint64_t span_id = 0;
+        };
+
+        struct SpanRecord
+        {
+            const char *name; // must be a string literal
+            char detail[88];  // truncated, NUL-terminated
+            uint64_t trace_id;
+            uint64_t span_id;
+            uint64_t parent_span_id;
+            int64_t start_ns; // steady clock
+            int64_t end_ns;
+            uint32_t thread_index;
+        };
+
+        namespace detail
+        {
+            inline std::atomic<bool> enabled{false};
+        }
+
+        // Spans are only recorded while tracing is enabled; a disabled ScopedSpan
+        // costs one relaxed atomic load.
+        void Enable(bool enabled = true);
+        inline bool IsEnabled() { return detail::enabled.load(std::memory_order_relaxed); }
+
+        // Context of the innermost open span on this thread. Capture it before
+        // handing work to another thread and adopt it there with ScopedContext.
+        TraceContext CurrentContext();
+
+        // Snapshot of every thread's ring buffer, oldest first per thread.
+        std::vector<SpanRecord> CollectSpans();
+
+        // Chrome trace-event JSON, loadable in chrome://tracing or Perfetto.
+        bool WriteChromeTrace(const std::string &filepath);
+        // OTLP/JSON ExportTraceServiceRequest, accepted by OpenTelemetry collectors.
+        bool WriteOtlpJson(const std::string &filepath, const std::string &service_name = "rag_app");
+
+        class ScopedContext
+        {
+        public:
+            explicit ScopedContext(const TraceContext &context);
+            ~ScopedContext();
+
+            ScopedContext(const ScopedContext &) = delete;
+            ScopedContext &operator=(const ScopedContext &) = delete;
+
+        private:
+            TraceContext previous;
+        };
+
+        // Records [construction, destruction) as a child of the current span, or as
+        // the root of a new trace when there is none.
+        class ScopedSpan
+        {
+        public:
+            explicit ScopedSpan(const char *name, std::string_view detail = {})
+            {
+                if (IsEnabled())
+                {
+                    Begin(name, detail);
+                }
+            }
+
+            ~ScopedSpan()
+            {
+                if (active)
+                {
+                    End();
+                }
+            }
+
+            ScopedSpan(const ScopedSpan &) = delete;
+            ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+        private:
+            void Begin(const char *name, std::string_view detail);
+            void End();
+
+            bool active = false;
+            TraceContext previous;
+            SpanRecord record;
+        };
+    };
+};
@@ -0,0 +1,265 @@
+#include "HttpServer.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace tools
+{
+    namespace common
+    {
+        namespace
+        {
+            const char *StatusText(int status_code)
+            {
+                switch (status_code)
+                {
+                case 200:
+                    return "OK";
+                case 400:
+                    return "Bad Request";
+                case 404:
+                    return "Not Found";
+                case 500:
+                    return "Internal Server Error";
+                case 503:
+                    return "Service Unavailable";
+                default:
+                    return "Unknown";
+                }
+            }
+
+            bool SendAll(int fd, const std::string &data)
+            {
+                size_t sent = 0;
+                while (sent < data.size())
+                {
+                    const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                    if (n <= 0)
+                    {
+                        return false;
+                    }
+                    sent += static_cast<size_t>(n);
+                }
+                return true;
+            }
+
+            std::string ToLower(std::string value)
+            {
+                std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c)
+                               { return static_cast<char>(std::tolower(c)); });
+                return value;
+            }
+
+            std::string Trim(const std::string &value)
+            {
+                const size_t start = value.find_first_not_of(" \t\r");
+                if (start == std::string::npos)
+                {
+                    return "";
+                }
+                const size_t end = value.find_last_not_of(" \t\r");
+                return value.substr(start, end - start + 1);
+            }
+        }
+
+        HttpServer::HttpServer(Handler handler, unsigned short port, const std::string &host)
+            : handler(std::move(handler)), host(host)
+        {
+            listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (listen_fd < 0)
+            {
+                throw std::runtime_error("Could not create server socket");
+            }
+
+            const int enable = 1;
+            ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            if (::inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1 ||
+                ::bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+                ::listen(listen_fd, SOMAXCONN) != 0)
+            {
+                ::close(listen_fd);
+                throw std::runtime_error("Could not listen on " + host + ":" + std::to_string(port));
+            }
+
+            socklen_t length = sizeof(address);
+            ::getsockname(listen_fd, reinterpret_cast<sockaddr *>(&address), &length);
+            this->port = ntohs(address.sin_port);
+
+            acceptor = std::thread([this]()
+                                   { AcceptLoop(); });
+        }
+
+        HttpServer::~HttpServer()
+        {
+            Stop();
+        }
+
+        std::string HttpServer::BaseUrl() const
+        {
+            return "http://" + host + ":" + std::to_string(port);
+        }
+
+        void HttpServer::Stop()
+        {
+            if (stopping.exchange(true))
+            {
+                return;
+            }
+
+            ::shutdown(listen_fd, SHUT_RDWR);
+            ::close(listen_fd);
+            acceptor.join();
+
+            std::unique_lock<std::mutex> lock(connections_mutex);
+            for (const int fd : open_connections)
+            {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+            connections_done.wait(lock, [this]()
+                                  { return open_connections.empty(); });
+        }
+
+        void HttpServer::AcceptLoop()
+        {
+            while (!stopping.load())
+            {
+                const int client_fd = ::accept(listen_fd, nullptr, nullptr);
+                if (client_fd < 0)
+                {
+                    if (stopping.load())
+                    {
+                        return;
+                    }
+                    continue;
+                }
+
+                const int enable = 1;
+                ::setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+                {
+                    std::lock_guard<std::mutex> lock(connections_mutex);
+                    open_connections.insert(client_fd);
+                }
+                std::thread([this, client_fd]()
+                            { ServeConnection(client_fd); })
+                    .detach();
+            }
+        }
+
+        void HttpServer::ServeConnection(int client_fd)
+        {
+            std::string buffer;
+            char chunk[16384];
+            bool keep_alive = true;
+
+            while (keep_alive && !stopping.load())
+            {
+                // Read the request head
+                size_t head_end;
+                while ((head_end = buffer.find("\r\n\r\n")) == std::string::npos)
+                {
+                    const ssize_t n = ::recv(client_fd, chunk, sizeof(chunk), 0);
+                    if (n <= 0)
+                    {
+                        keep_alive = false;
+                        break;
+                    }
+                    buffer.append(chunk, static_cast<size_t>(n));
+                }
+                if (!keep_alive)
+                {
+                    break;
+                }
+
+                HttpRequest request;
+                std::istringstream head(buffer.substr(0, head_end));
+                std::string line;
+                std::getline(head, line);
+                std::istringstream request_line(line);
+                std::string version;
+                request_line >> request.method >> request.path >> version;
+                while (std::getline(head, line))
+                {
+                    const size_t colon = line.find(':');
+                    if (colon != std::string::npos)
+                    {
+                        request.headers[ToLower(Trim(line.substr(0, colon)))] = Trim(line.substr(colon + 1));
+                    }
+                }
+                buffer.erase(0, head_end + 4);
+
+                // libcurl waits for an interim response before sending large bodies
+                const auto expect = request.headers.find("expect");
+                if (expect != request.headers.end() && ToLower(expect->second) == "100-continue")
+                {
+                    SendAll(client_fd, "HTTP/1.1 100 Continue\r\n\r\n");
+                }
+
+                size_t content_length = 0;
+                const auto length_header = request.headers.find("content-length");
+                if (length_header != request.headers.end())
+                {
+                    content_length = std::stoul(length_header->second);
+                }
+                while (buffer.size() < content_length)
+                {
+                    const ssize_t n = ::recv(client_fd, chunk, sizeof(chunk), 0);
+                    if (n <= 0)
+                    {
+                        keep_alive = false;
+                        break;
+                    }
+                    buffer.append(chunk, static_cast<size_t>(n));
+                }
+                if (!keep_alive)
+                {
+                    break;
+                }
+                request.body = buffer.substr(0, content_length);
+                buffer.erase(0, content_length);
+
+                const auto connection = request.headers.find("connection");
+                keep_alive = version == "HTTP/1.1" &&
+                             (connection == request.headers.end() || ToLower(connection->second) != "close");
+
+                HttpReply reply;
+                try
+                {
+                    reply = handler(request);
+                }
+                catch (const std::exception &e)
+                {
+                    reply.status_code = 500;
+                    reply.body = std::string("{\"error\":\"") + e.what() + "\"}";
+                }
+
+                std::string response = "HTTP/1.1 " + std::to_string(reply.status_code) + " " + StatusText(reply.status_code) +
+                                       "\r\nContent-Type: " + reply.content_type +
+                                       "\r\nContent-Length: " + std::to_string(reply.body.size()) +
+                                       (keep_alive ? "\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+                response += reply.body;
+                if (!SendAll(client_fd, response))
+                {
+                    break;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            ::close(client_fd);
+            open_connections.erase(client_fd);
+            connections_done.notify_all();
+        }
+    };
+};
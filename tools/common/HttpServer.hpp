@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace tools
+{
+    namespace common
+    {
+        struct HttpRequest
+        {
+            std::string method;
+            std::string path;
+            std::map<std::string, std::string> headers; // keys lower-cased
+            std::string body;
+        };
+
+        struct HttpReply
+        {
+            int status_code = 200;
+            std::string body;
+            std::string content_type = "application/json";
+        };
+
+        // Minimal HTTP/1.1 server for benchmarks and local stand-in backends.
+        // One thread per connection, keep-alive supported; not meant to face the network.
+        class HttpServer
+        {
+        public:
+            using Handler = std::function<HttpReply(const HttpRequest &)>;
+
+            // Listens on 127.0.0.1; port 0 picks a free ephemeral port.
+            explicit HttpServer(Handler handler, unsigned short port = 0, const std::string &host = "127.0.0.1");
+            ~HttpServer();
+
+            HttpServer(const HttpServer &) = delete;
+            HttpServer &operator=(const HttpServer &) = delete;
+
+            unsigned short Port() const { return port; }
+            std::string BaseUrl() const;
+            void Stop();
+
+        private:
+            void AcceptLoop();
+            void ServeConnection(int client_fd);
+
+            Handler handler;
+            std::string host;
+            unsigned short port = 0;
+            int listen_fd = -1;
+            std::thread acceptor;
+
+            std::atomic<bool> stopping{false};
+            std::mutex connections_mutex;
+            std::condition_variable connections_done;
+            std::set<int> open_connections;
+        };
+    };
+};
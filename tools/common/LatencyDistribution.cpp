@@ -0,0 +1,82 @@
+#include "LatencyDistribution.hpp"
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace tools
+{
+    namespace common
+    {
+        LatencyDistribution::LatencyDistribution(const std::string &spec, unsigned int seed) : generator(seed)
+        {
+            std::vector<std::string> parts;
+            std::istringstream stream(spec);
+            std::string part;
+            while (std::getline(stream, part, ':'))
+            {
+                parts.push_back(part);
+            }
+
+            if (parts.empty() || parts[0] == "none")
+            {
+                kind = Kind::None;
+            }
+            else if (parts[0] == "fixed" && parts.size() == 2)
+            {
+                kind = Kind::Fixed;
+                first = std::stod(parts[1]);
+            }
+            else if (parts[0] == "uniform" && parts.size() == 3)
+            {
+                kind = Kind::Uniform;
+                first = std::stod(parts[1]);
+                second = std::stod(parts[2]);
+            }
+            else if (parts[0] == "lognormal" && parts.size() == 3)
+            {
+                kind = Kind::LogNormal;
+                first = std::log(std::stod(parts[1]));
+                second = std::stod(parts[2]);
+            }
+            else
+            {
+                throw std::invalid_argument("Invalid latency distribution: " + spec);
+            }
+        }
+
+        std::chrono::microseconds LatencyDistribution::Sample()
+        {
+            double milliseconds = 0.0;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                switch (kind)
+                {
+                case Kind::None:
+                    break;
+                case Kind::Fixed:
+                    milliseconds = first;
+                    break;
+                case Kind::Uniform:
+                    milliseconds = std::uniform_real_distribution<double>(first, second)(generator);
+                    break;
+                case Kind::LogNormal:
+                    milliseconds = std::lognormal_distribution<double>(first, second)(generator);
+                    break;
+                }
+            }
+            return std::chrono::microseconds(static_cast<long long>(milliseconds * 1000.0));
+        }
+
+        void LatencyDistribution::SleepSample()
+        {
+            const std::chrono::microseconds delay = Sample();
+            if (delay.count() > 0)
+            {
+                std::this_thread::sleep_for(delay);
+            }
+        }
+    };
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+
+namespace tools
+{
+    namespace common
+    {
+        // Parsed from "none", "fixed:MS", "uniform:MIN_MS:MAX_MS" or
+        // "lognormal:MEDIAN_MS:SIGMA" (long right tail, like real model servers).
+        class LatencyDistribution
+        {
+        public:
+            explicit LatencyDistribution(const std::string &spec = "none", unsigned int seed = 1);
+
+            std::chrono::microseconds Sample();
+            void SleepSample();
+
+        private:
+            enum class Kind
+            {
+                None,
+                Fixed,
+                Uniform,
+                LogNormal,
+            };
+
+            Kind kind = Kind::None;
+            double first = 0.0;
+            double second = 0.0;
+            std::mt19937 generator;
+            std::mutex mutex;
+        };
+    };
+};
@@ -0,0 +1,184 @@
+#include "LoadGenerator.hpp"
+
+#include "util/concurrency/ThreadPool.hpp"
+#include "util/trace/Tracer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace tools
+{
+    namespace loadgen
+    {
+        namespace
+        {
+            using Clock = std::chrono::steady_clock;
+
+            double ElapsedMs(Clock::time_point start, Clock::time_point end)
+            {
+                return std::chrono::duration<double, std::milli>(end - start).count();
+            }
+
+            Percentiles Summarize(std::vector<double> samples)
+            {
+                Percentiles percentiles;
+                if (samples.empty())
+                {
+                    return percentiles;
+                }
+                std::sort(samples.begin(), samples.end());
+                const auto rank = [&samples](double quantile)
+                {
+                    const size_t index = static_cast<size_t>(std::ceil(quantile * static_cast<double>(samples.size())));
+                    return samples[std::min(samples.size() - 1, index == 0 ? 0 : index - 1)];
+                };
+                percentiles.p50 = rank(0.50);
+                percentiles.p95 = rank(0.95);
+                percentiles.p99 = rank(0.99);
+                percentiles.max = samples.back();
+                return percentiles;
+            }
+
+            struct Samples
+            {
+                std::mutex mutex;
+                std::vector<double> queue_ms;
+                std::vector<double> embed_ms;
+                std::vector<double> search_ms;
+                std::vector<double> generate_ms;
+                std::vector<double> total_ms;
+                size_t errors = 0;
+                size_t expired = 0;
+            };
+        }
+
+        LoadReport LoadGenerator::Run(const std::vector<std::string> &queries, const LoadOptions &options) const
+        {
+            LoadReport report;
+            report.offered_rate = options.rate;
+            if (queries.empty() || options.rate <= 0.0)
+            {
+                return report;
+            }
+
+            Samples samples;
+            std::mt19937 generator(options.seed);
+            std::exponential_distribution<double> interarrival(options.rate);
+
+            const Clock::time_point start = Clock::now();
+            const Clock::time_point stop = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration_s));
+            {
+                util::concurrency::ThreadPool pool(options.workers);
+                Clock::time_point arrival = start;
+                while (true)
+                {
+                    arrival += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interarrival(generator)));
+                    if (arrival >= stop)
+                    {
+                        break;
+                    }
+                    std::this_thread::sleep_until(arrival);
+
+                    const std::string &query = queries[report.issued++ % queries.size()];
+                    pool.Submit([this, &samples, &options, &query, arrival]()
+                                {
+                        util::trace::ScopedSpan span("loadgen.query", query);
+                        util::arena::RequestArena arena;
+                        const Clock::time_point started = Clock::now();
+                        // Queueing spends the same budget the services see
+                        const util::context::RequestContext context = options.deadline.count() > 0
+                                                                          ? util::context::RequestContext::WithTimeout(options.deadline, arrival)
+                                                                          : util::context::RequestContext::Background();
+                        try
+                        {
+                            const util::embedding::EmbeddingMatrix embedding = embedder_service.GetEmbedding(query, context);
+                            const Clock::time_point embedded = Clock::now();
+
+                            const auto results = vector_service.HybridSearch(collection_name, query, embedding.Row(0), arena, options.top_k, context);
+                            const Clock::time_point searched = Clock::now();
+
+                            std::vector<std::string_view> context_documents;
+                            for (const auto &result : results)
+                            {
+                                context_documents.push_back(result.payload);
+                            }
+                            llm_service.GenerateAnswer(query, context_documents, arena, options.max_tokens, context);
+                            const Clock::time_point generated = Clock::now();
+
+                            std::lock_guard<std::mutex> lock(samples.mutex);
+                            samples.queue_ms.push_back(ElapsedMs(arrival, started));
+                            samples.embed_ms.push_back(ElapsedMs(started, embedded));
+                            samples.search_ms.push_back(ElapsedMs(embedded, searched));
+                            samples.generate_ms.push_back(ElapsedMs(searched, generated));
+                            samples.total_ms.push_back(ElapsedMs(arrival, generated));
+                        }
+                        catch (const util::context::DeadlineExceeded &)
+                        {
+                            std::lock_guard<std::mutex> lock(samples.mutex);
+                            ++samples.errors;
+                            ++samples.expired;
+                        }
+                        catch (const std::exception &)
+                        {
+                            std::lock_guard<std::mutex> lock(samples.mutex);
+                            ++samples.errors;
+                        } });
+                }
+                pool.WaitIdle();
+            }
+            const double elapsed_s = ElapsedMs(start, Clock::now()) / 1000.0;
+
+            report.completed = samples.total_ms.size();
+            report.errors = samples.errors;
+            report.expired = samples.expired;
+            report.throughput = static_cast<double>(report.completed) / elapsed_s;
+            report.queue_ms = Summarize(std::move(samples.queue_ms));
+            report.embed_ms = Summarize(std::move(samples.embed_ms));
+            report.search_ms = Summarize(std::move(samples.search_ms));
+            report.generate_ms = Summarize(std::move(samples.generate_ms));
+            report.total_ms = Summarize(std::move(samples.total_ms));
+            return report;
+        }
+
+        void PrintReportHeader(std::ostream &out)
+        {
+            out << std::left << std::setw(10) << "offered" << std::setw(10) << "achieved" << std::setw(8) << "errors" << std::setw(9) << "expired"
+                << std::setw(10) << "stage" << std::right << std::setw(10) << "p50 ms" << std::setw(10) << "p95 ms"
+                << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << "\n";
+        }
+
+        void PrintReport(std::ostream &out, const LoadReport &report)
+        {
+            const std::pair<const char *, const Percentiles *> stages[] = {
+                {"queue", &report.queue_ms},
+                {"embed", &report.embed_ms},
+                {"search", &report.search_ms},
+                {"generate", &report.generate_ms},
+                {"total", &report.total_ms},
+            };
+
+            out << std::fixed << std::setprecision(1);
+            for (size_t i = 0; i < std::size(stages); ++i)
+            {
+                out << std::left;
+                if (i == 0)
+                {
+                    out << std::setw(10) << report.offered_rate << std::setw(10) << report.throughput << std::setw(8) << report.errors << std::setw(9) << report.expired;
+                }
+                else
+                {
+                    out << std::setw(37) << "";
+                }
+                const Percentiles &percentiles = *stages[i].second;
+                out << std::setw(10) << stages[i].first << std::right << std::setw(10) << percentiles.p50
+                    << std::setw(10) << percentiles.p95 << std::setw(10) << percentiles.p99 << std::setw(10) << percentiles.max << "\n";
+            }
+            out.flush();
+        }
+    };
+};
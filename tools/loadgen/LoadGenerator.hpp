@@ -0,0 +1,77 @@
+#pragma once
+
+#include "services/embedder/EmbedderService.hpp"
+#include "services/vector/VectorService.hpp"
+#include "services/llm/LlmService.hpp"
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace tools
+{
+    namespace loadgen
+    {
+        struct LoadOptions
+        {
+            double rate = 10.0;      // offered queries per second
+            double duration_s = 30.0;
+            size_t workers = 64;     // maximum queries in flight
+            int top_k = 5;
+            unsigned int max_tokens = 128;
+            unsigned int seed = 7;
+            std::chrono::milliseconds deadline{0}; // per query from its scheduled arrival; 0 for none
+        };
+
+        struct Percentiles
+        {
+            double p50 = 0.0;
+            double p95 = 0.0;
+            double p99 = 0.0;
+            double max = 0.0;
+        };
+
+        struct LoadReport
+        {
+            double offered_rate = 0.0;
+            double throughput = 0.0; // completed queries per second of wall time
+            size_t issued = 0;
+            size_t completed = 0;
+            size_t errors = 0;
+            size_t expired = 0; // errors that were deadline misses
+            Percentiles queue_ms;
+            Percentiles embed_ms;
+            Percentiles search_ms;
+            Percentiles generate_ms;
+            Percentiles total_ms;
+        };
+
+        // Open-loop driver: arrivals follow a Poisson process at the offered rate
+        // regardless of how fast earlier queries complete, and every latency is
+        // measured from the scheduled arrival so queueing in the client is visible.
+        class LoadGenerator
+        {
+        private:
+            const services::embedder::EmbedderService &embedder_service;
+            const services::vector::VectorService &vector_service;
+            const services::llm::LlmService &llm_service;
+            std::string collection_name;
+
+        public:
+            LoadGenerator(const services::embedder::EmbedderService &embedder_service,
+                          const services::vector::VectorService &vector_service,
+                          const services::llm::LlmService &llm_service,
+                          std::string collection_name)
+                : embedder_service(embedder_service),
+                  vector_service(vector_service),
+                  llm_service(llm_service),
+                  collection_name(std::move(collection_name)) {}
+
+            LoadReport Run(const std::vector<std::string> &queries, const LoadOptions &options) const;
+        };
+
+        void PrintReportHeader(std::ostream &out);
+        void PrintReport(std::ostream &out, const LoadReport &report);
+    };
+};
@@ -0,0 +1,171 @@
+#include "LoadGenerator.hpp"
+
+#include "util/env/EnvLoader.hpp"
+#include "util/http_client/HttpClient.hpp"
+#include "util/trace/Tracer.hpp"
+
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace
+{
+    struct Options
+    {
+        std::vector<double> rates = {1.0, 2.0, 5.0, 10.0};
+        tools::loadgen::LoadOptions load;
+        std::string collection_name = "loadgen_collection";
+        size_t documents = 1000;
+        std::string trace_output;
+    };
+
+    bool ParseOptions(int argc, char *argv[], Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc)
+            {
+                return false;
+            }
+            const std::string value = argv[++i];
+
+            if (arg == "--rates")
+            {
+                options.rates.clear();
+                std::istringstream stream(value);
+                std::string rate;
+                while (std::getline(stream, rate, ','))
+                {
+                    options.rates.push_back(std::stod(rate));
+                }
+            }
+            else if (arg == "--duration")
+                options.load.duration_s = std::stod(value);
+            else if (arg == "--workers")
+                options.load.workers = std::stoul(value);
+            else if (arg == "--top-k")
+                options.load.top_k = std::stoi(value);
+            else if (arg == "--max-tokens")
+                options.load.max_tokens = static_cast<unsigned int>(std::stoul(value));
+            else if (arg == "--deadline")
+                options.load.deadline = std::chrono::milliseconds(std::stol(value));
+            else if (arg == "--collection")
+                options.collection_name = value;
+            else if (arg == "--documents")
+                options.documents = std::stoul(value);
+            else if (arg == "--trace")
+                options.trace_output = value;
+            else
+                return false;
+        }
+        return !options.rates.empty();
+    }
+
+    std::string SyntheticText(size_t index, size_t words)
+    {
+        static const char *const vocabulary[] = {"retrieval", "augmented", "generation", "vector", "database",
+                                                 "corporate", "knowledge", "article", "embedding", "query",
+                                                 "programming", "language", "system", "design", "team", "expert"};
+        std::string text;
+        size_t state = index * 2654435761u + 1;
+        for (size_t i = 0; i < words; ++i)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            if (i > 0)
+                text += ' ';
+            text += vocabulary[(state >> 33) % 16];
+        }
+        return text;
+    }
+
+    void SeedCollection(const services::embedder::EmbedderService &embedder_service,
+                        services::vector::VectorService &vector_service,
+                        const std::string &collection_name,
+                        size_t documents)
+    {
+        vector_service.DeleteCollection(collection_name);
+
+        const size_t batch_size = 64;
+        for (size_t begin = 0; begin < documents; begin += batch_size)
+        {
+            std::vector<std::string> texts;
+            for (size_t i = begin; i < std::min(begin + batch_size, documents); ++i)
+            {
+                texts.push_back(SyntheticText(i, 12));
+            }
+            const util::embedding::EmbeddingMatrix embeddings = embedder_service.GetEmbeddings(texts);
+            if (begin == 0)
+            {
+                vector_service.CreateCollection(collection_name, static_cast<int>(embeddings.Dimension())).ThrowErrorIfFailed();
+            }
+
+            std::vector<repositories::vector::VectorPoint> points;
+            for (size_t i = 0; i < texts.size(); ++i)
+            {
+                points.push_back(repositories::vector::VectorPoint{static_cast<repositories::vector::PointId>(begin + i), embeddings.Row(i), json{{"text", texts[i]}}.dump()});
+            }
+            vector_service.UpsertPoints(collection_name, points).ThrowErrorIfFailed();
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--rates R1,R2,...] [--duration S] [--workers N] [--top-k N] [--max-tokens N] [--deadline MS]\n"
+                  << "       [--collection NAME] [--documents N] [--trace trace.json]" << std::endl;
+        return 1;
+    }
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    // Same configuration as rag_app, falling back to the stand-in defaults
+    util::env::EnvLoader env_loader;
+    env_loader.Load(".env");
+    const util::http::BalancingPolicy balancing = util::http::ParseBalancingPolicy(env_loader.Get("REPLICA_BALANCING", "least-outstanding"));
+    util::http::HttpClient llm_client = util::http::HttpClient::FromUrlList(env_loader.Get("LLM_SERVICE_URL", "http://localhost:8080"), balancing);
+    util::http::HttpClient embedder_client = util::http::HttpClient::FromUrlList(env_loader.Get("EMBEDDER_SERVICE_URL", "http://localhost:8081"), balancing);
+    util::http::HttpClient vector_client(env_loader.Get("VECTOR_DB_URL", "http://localhost:6333"));
+
+    services::llm::LlmService llm_service(repositories::llm::LlmRepository(std::move(llm_client)));
+    services::embedder::EmbedderService embedder_service(repositories::embedder::EmbedderRepository(std::move(embedder_client)));
+    services::vector::VectorService vector_service(repositories::vector::VectorRepository(std::move(vector_client)));
+
+    std::cout << "Seeding '" << options.collection_name << "' with " << options.documents << " documents..." << std::endl;
+    SeedCollection(embedder_service, vector_service, options.collection_name, options.documents);
+
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < 256; ++i)
+    {
+        queries.push_back(SyntheticText(options.documents + i, 8));
+    }
+
+    // Only the measured runs are traced, not the seeding
+    util::trace::Enable(!options.trace_output.empty());
+
+    const tools::loadgen::LoadGenerator generator(embedder_service, vector_service, llm_service, options.collection_name);
+    tools::loadgen::PrintReportHeader(std::cout);
+    for (const double rate : options.rates)
+    {
+        options.load.rate = rate;
+        tools::loadgen::PrintReport(std::cout, generator.Run(queries, options.load));
+    }
+
+    if (!options.trace_output.empty() && util::trace::WriteChromeTrace(options.trace_output))
+    {
+        std::cout << "Wrote trace to " << options.trace_output << std::endl;
+    }
+
+    curl_global_cleanup();
+    return 0;
+}
@@ -0,0 +1,365 @@
+#include "StubBackends.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <sstream>
+
+using json = nlohmann::json;
+
+namespace tools
+{
+    namespace stub_backends
+    {
+        namespace
+        {
+            uint64_t Fnv1a(const std::string &text)
+            {
+                uint64_t hash = 1469598103934665603ULL;
+                for (const char c : text)
+                {
+                    hash ^= static_cast<unsigned char>(c);
+                    hash *= 1099511628211ULL;
+                }
+                return hash;
+            }
+
+            std::vector<std::string> SplitPath(const std::string &path)
+            {
+                std::vector<std::string> segments;
+                std::istringstream stream(path.substr(0, path.find('?')));
+                std::string segment;
+                while (std::getline(stream, segment, '/'))
+                {
+                    if (!segment.empty())
+                    {
+                        segments.push_back(segment);
+                    }
+                }
+                return segments;
+            }
+
+            common::HttpReply JsonReply(int status_code, const json &body)
+            {
+                return common::HttpReply{status_code, body.dump()};
+            }
+
+            common::HttpReply QdrantOk(const json &result)
+            {
+                return JsonReply(200, {{"result", result}, {"status", "ok"}, {"time", 0.0}});
+            }
+
+            common::HttpReply QdrantError(int status_code, const std::string &message)
+            {
+                return JsonReply(status_code, {{"status", {{"error", message}}}, {"time", 0.0}});
+            }
+        }
+
+        std::vector<float> FakeEmbedding(const std::string &text, size_t dimension)
+        {
+            std::mt19937_64 generator(Fnv1a(text));
+            std::normal_distribution<float> distribution(0.0f, 1.0f);
+            std::vector<float> values(dimension);
+            for (float &value : values)
+            {
+                value = distribution(generator);
+            }
+            util::embedding::Normalize(util::embedding::RowView(values.data(), values.size()));
+            return values;
+        }
+
+        common::HttpReply EmbedderStub::Handle(const common::HttpRequest &request)
+        {
+            if (request.method == "GET" && request.path == "/health")
+            {
+                return JsonReply(200, {{"status", "ok"}});
+            }
+            if (request.method != "POST" || request.path != "/v1/embeddings")
+            {
+                return JsonReply(404, {{"error", "not found"}});
+            }
+
+            const json body = json::parse(request.body);
+            std::vector<std::string> inputs;
+            if (body["input"].is_array())
+            {
+                inputs = body["input"].get<std::vector<std::string>>();
+            }
+            else
+            {
+                inputs.push_back(body["input"].get<std::string>());
+            }
+
+            latency.SleepSample();
+
+            json data = json::array();
+            for (size_t i = 0; i < inputs.size(); ++i)
+            {
+                data.push_back({{"object", "embedding"}, {"index", i}, {"embedding", FakeEmbedding(inputs[i], dimension)}});
+            }
+            return JsonReply(200, {{"object", "list"}, {"data", data}, {"model", "stub"}});
+        }
+
+        common::HttpReply LlmStub::Handle(const common::HttpRequest &request)
+        {
+            if (request.method == "GET" && request.path == "/health")
+            {
+                return JsonReply(200, {{"status", "ok"}});
+            }
+            if (request.method != "POST" || request.path != "/v1/completions")
+            {
+                return JsonReply(404, {{"error", "not found"}});
+            }
+
+            const json body = json::parse(request.body);
+            const std::string prompt = body.value("prompt", "");
+
+            latency.SleepSample();
+
+            const std::string text = " This is a stand-in answer for a prompt of " + std::to_string(prompt.size()) + " characters.";
+            return JsonReply(200, {{"object", "text_completion"}, {"model", "stub"}, {"choices", {{{"index", 0}, {"text", text}, {"finish_reason", "stop"}}}}});
+        }
+
+        json VectorDbStub::Search(const Collection &collection, const json &request) const
+        {
+            std::vector<float> query = request["vector"].get<std::vector<float>>();
+            util::embedding::Normalize(util::embedding::RowView(query.data(), query.size()));
+            const size_t limit = request.value("limit", 10);
+            const bool with_payload = request.value("with_payload", false);
+
+            const std::vector<float> scores = util::embedding::ScoreRows(collection.vectors, query);
+            std::vector<size_t> order(scores.size());
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                order[i] = i;
+            }
+
+            const size_t count = std::min(limit, order.size());
+            std::partial_sort(order.begin(), order.begin() + count, order.end(), [&scores](size_t lhs, size_t rhs)
+                              { return scores[lhs] > scores[rhs]; });
+
+            json results = json::array();
+            for (size_t i = 0; i < count; ++i)
+            {
+                json result = {{"id", collection.ids[order[i]]}, {"version", 0}, {"score", scores[order[i]]}};
+                if (with_payload)
+                {
+                    result["payload"] = collection.payloads[order[i]];
+                }
+                results.push_back(std::move(result));
+            }
+            return results;
+        }
+
+        json VectorDbStub::Scroll(const Collection &collection, const json &request) const
+        {
+            const size_t limit = request.value("limit", 10);
+            const auto offset = request.find("offset");
+            const uint64_t first = offset != request.end() && offset->is_number_unsigned() ? offset->get<uint64_t>() : 0;
+            const json with_payload = request.value("with_payload", json(true));
+            const bool with_vector = request.value("with_vector", false);
+
+            std::vector<std::pair<uint64_t, size_t>> rows;
+            for (size_t row = 0; row < collection.ids.size(); ++row)
+            {
+                if (collection.ids[row].is_number_unsigned() && collection.ids[row].get<uint64_t>() >= first)
+                {
+                    rows.emplace_back(collection.ids[row].get<uint64_t>(), row);
+                }
+            }
+            // One extra row tells us where the next page starts
+            const size_t count = std::min(limit + 1, rows.size());
+            std::partial_sort(rows.begin(), rows.begin() + count, rows.end());
+
+            json points = json::array();
+            for (size_t i = 0; i < std::min(limit, count); ++i)
+            {
+                const size_t row = rows[i].second;
+                json point = {{"id", rows[i].first}};
+                const json &payload = collection.payloads[row];
+                if (with_payload.is_array())
+                {
+                    json projected = json::object();
+                    for (const auto &field : with_payload)
+                    {
+                        if (field.is_string() && payload.contains(field.get<std::string>()))
+                        {
+                            projected[field.get<std::string>()] = payload[field.get<std::string>()];
+                        }
+                    }
+                    point["payload"] = std::move(projected);
+                }
+                else if (with_payload.is_boolean() && with_payload.get<bool>())
+                {
+                    point["payload"] = payload;
+                }
+                if (with_vector)
+                {
+                    const util::embedding::ConstRowView values = collection.vectors.Row(row);
+                    point["vector"] = std::vector<float>(values.begin(), values.end());
+                }
+                points.push_back(std::move(point));
+            }
+            return {{"points", std::move(points)}, {"next_page_offset", count > limit ? json(rows[limit].first) : json(nullptr)}};
+        }
+
+        common::HttpReply VectorDbStub::Handle(const common::HttpRequest &request)
+        {
+            const std::vector<std::string> segments = SplitPath(request.path);
+            if (segments.empty())
+            {
+                return JsonReply(200, {{"title", "qdrant stand-in"}, {"version", "stub"}});
+            }
+            if (segments[0] != "collections" || segments.size() < 2)
+            {
+                return QdrantError(404, "not found");
+            }
+
+            latency.SleepSample();
+
+            const std::string &name = segments[1];
+            std::string action;
+            for (size_t i = 2; i < segments.size(); ++i)
+            {
+                action += "/" + segments[i];
+            }
+
+            if (action.empty())
+            {
+                if (request.method == "PUT")
+                {
+                    const json body = json::parse(request.body);
+                    std::unique_lock<std::shared_mutex> lock(mutex);
+                    // Recreating a collection may change its dimension, so it is rebuilt rather than assigned
+                    collections.erase(name);
+                    collections.emplace(name, Collection{util::embedding::EmbeddingMatrix(body["vectors"]["size"].get<size_t>()), {}, {}, {}});
+                    return QdrantOk(true);
+                }
+                if (request.method == "DELETE")
+                {
+                    std::unique_lock<std::shared_mutex> lock(mutex);
+                    return QdrantOk(collections.erase(name) > 0);
+                }
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                const auto it = collections.find(name);
+                if (it == collections.end())
+                {
+                    return QdrantError(404, "Collection `" + name + "` doesn't exist!");
+                }
+                return QdrantOk({{"status", "green"},
+                                 {"points_count", it->second.ids.size()},
+                                 {"config", {{"params", {{"vectors", {{"size", it->second.vectors.Dimension()}, {"distance", "Cosine"}}}}}}}});
+            }
+
+            const json body = request.body.empty() ? json::object() : json::parse(request.body);
+
+            if (action == "/points" && request.method == "PUT")
+            {
+                std::unique_lock<std::shared_mutex> lock(mutex);
+                const auto it = collections.find(name);
+                if (it == collections.end())
+                {
+                    return QdrantError(404, "Collection `" + name + "` doesn't exist!");
+                }
+                Collection &collection = it->second;
+                for (const auto &point_json : body["points"])
+                {
+                    const json &values = point_json["vector"];
+                    if (!values.is_array() || values.size() != collection.vectors.Dimension())
+                    {
+                        return QdrantError(400, "Wrong input: Vector dimension error");
+                    }
+
+                    const std::string key = point_json["id"].dump();
+                    const auto existing = collection.row_by_id.find(key);
+                    util::embedding::RowView row;
+                    if (existing != collection.row_by_id.end())
+                    {
+                        row = collection.vectors.Row(existing->second);
+                        collection.payloads[existing->second] = point_json.value("payload", json::object());
+                    }
+                    else
+                    {
+                        collection.row_by_id.emplace(key, collection.ids.size());
+                        collection.ids.push_back(point_json["id"]);
+                        collection.payloads.push_back(point_json.value("payload", json::object()));
+                        row = collection.vectors.AppendRow();
+                    }
+                    for (size_t i = 0; i < row.size(); ++i)
+                    {
+                        row[i] = values[i].get<float>();
+                    }
+                    util::embedding::Normalize(row);
+                }
+                return QdrantOk({{"operation_id", 0}, {"status", "acknowledged"}});
+            }
+
+            if (action == "/points/delete" && request.method == "POST")
+            {
+                std::unique_lock<std::shared_mutex> lock(mutex);
+                const auto it = collections.find(name);
+                if (it == collections.end())
+                {
+                    return QdrantError(404, "Collection `" + name + "` doesn't exist!");
+                }
+                Collection &collection = it->second;
+                for (const auto &id : body["points"])
+                {
+                    const auto existing = collection.row_by_id.find(id.dump());
+                    if (existing == collection.row_by_id.end())
+                    {
+                        continue;
+                    }
+
+                    // The last row moves into the hole so the matrix stays dense
+                    const size_t row = existing->second;
+                    const size_t last = collection.ids.size() - 1;
+                    collection.row_by_id.erase(existing);
+                    collection.vectors.SwapRemoveRow(row);
+                    if (row != last)
+                    {
+                        collection.ids[row] = std::move(collection.ids[last]);
+                        collection.payloads[row] = std::move(collection.payloads[last]);
+                        collection.row_by_id[collection.ids[row].dump()] = row;
+                    }
+                    collection.ids.pop_back();
+                    collection.payloads.pop_back();
+                }
+                return QdrantOk({{"operation_id", 0}, {"status", "acknowledged"}});
+            }
+
+            if (action == "/points/scroll" && request.method == "POST")
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                const auto it = collections.find(name);
+                if (it == collections.end())
+                {
+                    return QdrantError(404, "Collection `" + name + "` doesn't exist!");
+                }
+                return QdrantOk(Scroll(it->second, body));
+            }
+
+            if ((action == "/points/search" || action == "/points/search/batch") && request.method == "POST")
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                const auto it = collections.find(name);
+                if (it == collections.end())
+                {
+                    return QdrantError(404, "Collection `" + name + "` doesn't exist!");
+                }
+                if (action == "/points/search")
+                {
+                    return QdrantOk(Search(it->second, body));
+                }
+                json results = json::array();
+                for (const auto &search : body["searches"])
+                {
+                    results.push_back(Search(it->second, search));
+                }
+                return QdrantOk(results);
+            }
+
+            return QdrantError(404, "not found");
+        }
+    };
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "common/HttpServer.hpp"
+#include "common/LatencyDistribution.hpp"
+#include "util/embedding/EmbeddingMatrix.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tools
+{
+    namespace stub_backends
+    {
+        // Unit-length vector derived only from the text, so repeated runs agree
+        std::vector<float> FakeEmbedding(const std::string &text, size_t dimension);
+
+        // Subset of llama.cpp's /v1/embeddings
+        class EmbedderStub
+        {
+        public:
+            EmbedderStub(size_t dimension, const std::string &latency_spec)
+                : dimension(dimension), latency(latency_spec, 11) {}
+
+            common::HttpReply Handle(const common::HttpRequest &request);
+
+        private:
+            size_t dimension;
+            common::LatencyDistribution latency;
+        };
+
+        // Subset of llama.cpp's /v1/completions
+        class LlmStub
+        {
+        public:
+            explicit LlmStub(const std::string &latency_spec) : latency(latency_spec, 13) {}
+
+            common::HttpReply Handle(const common::HttpRequest &request);
+
+        private:
+            common::LatencyDistribution latency;
+        };
+
+        // Qdrant collection and point endpoints used by VectorRepository, backed by
+        // an in-memory brute-force cosine index over one embedding matrix per collection
+        class VectorDbStub
+        {
+        public:
+            explicit VectorDbStub(const std::string &latency_spec) : latency(latency_spec, 17) {}
+
+            common::HttpReply Handle(const common::HttpRequest &request);
+
+        private:
+            // Row i of `vectors` belongs to ids[i] and payloads[i]
+            struct Collection
+            {
+                util::embedding::EmbeddingMatrix vectors; // normalized on insert
+                std::vector<nlohmann::json> ids;
+                std::vector<nlohmann::json> payloads;
+                std::unordered_map<std::string, size_t> row_by_id; // keyed by the serialized id
+            };
+
+            nlohmann::json Search(const Collection &collection, const nlohmann::json &request) const;
+            // Pages through points in id order; only unsigned integer ids are supported
+            nlohmann::json Scroll(const Collection &collection, const nlohmann::json &request) const;
+
+            common::LatencyDistribution latency;
+            std::map<std::string, Collection> collections;
+            std::shared_mutex mutex;
+        };
+    };
+};
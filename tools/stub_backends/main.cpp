@@ -0,0 +1,98 @@
+#include "StubBackends.hpp"
+
+#include "common/HttpServer.hpp"
+
+#include <csignal>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    struct Options
+    {
+        std::string host = "127.0.0.1";
+        unsigned short llm_port = 8080;
+        unsigned short embedder_port = 8081;
+        unsigned short vector_port = 6333;
+        size_t dimension = 768;
+        std::string embed_latency = "lognormal:15:0.4";
+        std::string completion_latency = "lognormal:800:0.5";
+        std::string search_latency = "lognormal:3:0.3";
+    };
+
+    bool ParseOptions(int argc, char *argv[], Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc)
+            {
+                return false;
+            }
+            const std::string value = argv[++i];
+
+            if (arg == "--host")
+                options.host = value;
+            else if (arg == "--llm-port")
+                options.llm_port = static_cast<unsigned short>(std::stoul(value));
+            else if (arg == "--embedder-port")
+                options.embedder_port = static_cast<unsigned short>(std::stoul(value));
+            else if (arg == "--vector-port")
+                options.vector_port = static_cast<unsigned short>(std::stoul(value));
+            else if (arg == "--dimension")
+                options.dimension = std::stoul(value);
+            else if (arg == "--embed-latency")
+                options.embed_latency = value;
+            else if (arg == "--completion-latency")
+                options.completion_latency = value;
+            else if (arg == "--search-latency")
+                options.search_latency = value;
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--host ADDR] [--llm-port N] [--embedder-port N] [--vector-port N] [--dimension N]\n"
+                  << "       [--embed-latency SPEC] [--completion-latency SPEC] [--search-latency SPEC]\n"
+                  << "SPEC is none | fixed:MS | uniform:MIN_MS:MAX_MS | lognormal:MEDIAN_MS:SIGMA" << std::endl;
+        return 1;
+    }
+
+    // Block termination signals in every server thread; main waits for them below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    tools::stub_backends::EmbedderStub embedder(options.dimension, options.embed_latency);
+    tools::stub_backends::LlmStub llm(options.completion_latency);
+    tools::stub_backends::VectorDbStub vector_db(options.search_latency);
+
+    tools::common::HttpServer embedder_server([&embedder](const tools::common::HttpRequest &request)
+                                              { return embedder.Handle(request); },
+                                              options.embedder_port, options.host);
+    tools::common::HttpServer llm_server([&llm](const tools::common::HttpRequest &request)
+                                         { return llm.Handle(request); },
+                                         options.llm_port, options.host);
+    tools::common::HttpServer vector_server([&vector_db](const tools::common::HttpRequest &request)
+                                            { return vector_db.Handle(request); },
+                                            options.vector_port, options.host);
+
+    std::cout << "Embeddings (" << options.dimension << "d, " << options.embed_latency << "): " << embedder_server.BaseUrl() << "\n"
+              << "Completions (" << options.completion_latency << "): " << llm_server.BaseUrl() << "\n"
+              << "Qdrant (" << options.search_latency << "): " << vector_server.BaseUrl() << std::endl;
+
+    int signal_number = 0;
+    sigwait(&signals, &signal_number);
+    std::cout << "Shutting down" << std::endl;
+    return 0;
+}